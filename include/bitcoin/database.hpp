@@ -15,23 +15,31 @@
  */
 
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/block_cache.hpp>
+#include <bitcoin/database/compression.hpp>
 #include <bitcoin/database/data_base.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/gap_index.hpp>
+#include <bitcoin/database/header_index.hpp>
 #include <bitcoin/database/settings.hpp>
+#include <bitcoin/database/short_ids.hpp>
 #include <bitcoin/database/store.hpp>
 #include <bitcoin/database/unspent_outputs.hpp>
-#include <bitcoin/database/unspent_transaction.hpp>
 #include <bitcoin/database/version.hpp>
 #include <bitcoin/database/databases/block_database.hpp>
 #include <bitcoin/database/databases/history_database.hpp>
 #include <bitcoin/database/databases/spend_database.hpp>
 #include <bitcoin/database/databases/stealth_database.hpp>
 #include <bitcoin/database/databases/transaction_database.hpp>
+#include <bitcoin/database/databases/unspent_database.hpp>
 #include <bitcoin/database/memory/accessor.hpp>
 #include <bitcoin/database/memory/allocator.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/memory/memory_map.hpp>
+#include <bitcoin/database/primitives/hash_set.hpp>
 #include <bitcoin/database/primitives/hash_table_header.hpp>
+#include <bitcoin/database/primitives/record_cluster_iterator.hpp>
+#include <bitcoin/database/primitives/record_cluster_multimap.hpp>
 #include <bitcoin/database/primitives/record_hash_table.hpp>
 #include <bitcoin/database/primitives/record_list.hpp>
 #include <bitcoin/database/primitives/record_manager.hpp>
@@ -40,7 +48,10 @@
 #include <bitcoin/database/primitives/record_multimap_iterator.hpp>
 #include <bitcoin/database/primitives/slab_hash_table.hpp>
 #include <bitcoin/database/primitives/slab_manager.hpp>
+#include <bitcoin/database/primitives/striped_mutex.hpp>
 #include <bitcoin/database/result/block_result.hpp>
+#include <bitcoin/database/result/offset_iterable.hpp>
+#include <bitcoin/database/result/offset_iterator.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
 
 #endif
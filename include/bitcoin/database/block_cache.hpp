@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_BLOCK_CACHE_HPP
+#define LIBBITCOIN_DATABASE_BLOCK_CACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A least-recently-used cache of wire serialized blocks by hash, so that
+/// recent blocks can be served to peers with a single contiguous copy.
+/// Capacity is in bytes of serialized block data.
+class BCD_API block_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<const data_chunk> data_ptr;
+
+    /// Construct a cache with the specified byte limit.
+    block_cache(size_t capacity);
+
+    /// The cache capacity is zero.
+    bool disabled() const;
+
+    /// The number of blocks in the cache.
+    size_t size() const;
+
+    /// The number of bytes of block data in the cache.
+    size_t usage() const;
+
+    /// Add a serialized block to the cache (purges least recently used).
+    /// A block larger than the capacity is not cached.
+    void add(const hash_digest& hash, data_chunk&& data);
+
+    /// Remove a block from the cache (has been reorganized out).
+    void remove(const hash_digest& hash);
+
+    /// Get the serialized block (null if not cached), marking it as used.
+    /// The data is shared, so no lock is held while it is copied or sent.
+    data_ptr get(const hash_digest& hash) const;
+
+private:
+    struct entry
+    {
+        hash_digest hash;
+        data_ptr data;
+    };
+
+    // The most recently used block is at the front of the queue.
+    typedef std::list<entry> queue;
+    typedef std::unordered_map<hash_digest, queue::iterator> position_map;
+
+    // Remove the queue entry and its position (caller must hold lock).
+    void erase(queue::iterator position);
+
+    const size_t capacity_;
+    size_t usage_;
+    mutable queue queue_;
+    position_map positions_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
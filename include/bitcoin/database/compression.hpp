@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_COMPRESSION_HPP
+#define LIBBITCOIN_DATABASE_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Compact storage encodings for transaction outputs.
+/// Amounts are reduced by factoring out trailing decimal zeros and stored as
+/// variable length integers (or escaped if above max_money). Standard script templates are stored as a code
+/// and hash, other scripts are stored as (size + templates) and raw bytes.
+
+/// Amounts above max_money are stored as this code followed by the raw value.
+static BC_CONSTEXPR uint64_t amount_escape = max_uint64;
+
+/// Compress an amount, amount_escape if the value exceeds max_money.
+BCD_API uint64_t compress_amount(uint64_t value);
+
+/// Decompress an amount (amount_escape is not decompressible).
+BCD_API uint64_t decompress_amount(uint64_t value);
+
+/// The stored size of the amount (compressed or escaped).
+BCD_API size_t compressed_amount_size(uint64_t value);
+
+/// Write the amount (compressed or escaped).
+BCD_API void compress_amount(writer& sink, uint64_t value);
+
+/// Read an amount written by compress_amount.
+BCD_API uint64_t decompress_amount(reader& source);
+
+/// The stored size of the compressed script (including code).
+BCD_API size_t compressed_script_size(const chain::script& script);
+
+/// Write the compressed script (including code).
+BCD_API void compress_script(writer& sink, const chain::script& script);
+
+/// The number of payload bytes stored following the script code.
+BCD_API size_t script_payload_size(uint64_t code);
+
+/// The size of the decompressed script (excluding size prefix).
+BCD_API size_t script_size(uint64_t code);
+
+/// Write the decompressed script (excluding size prefix).
+BCD_API void decompress_script(writer& sink, uint64_t code,
+    const uint8_t* payload);
+
+/// The decompressed script (excluding size prefix).
+BCD_API data_chunk decompress_script(uint64_t code, const uint8_t* payload);
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -24,12 +24,14 @@
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/block_cache.hpp>
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/databases/block_database.hpp>
 #include <bitcoin/database/databases/spend_database.hpp>
 #include <bitcoin/database/databases/transaction_database.hpp>
 #include <bitcoin/database/databases/history_database.hpp>
 #include <bitcoin/database/databases/stealth_database.hpp>
+#include <bitcoin/database/databases/unspent_database.hpp>
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/settings.hpp>
 #include <bitcoin/database/store.hpp>
@@ -73,6 +75,8 @@ public:
 
     const transaction_database& transactions() const;
 
+    const unspent_database& unspents() const;
+
     /// Invalid if indexes not initialized.
     const spend_database& spends() const;
 
@@ -82,6 +86,10 @@ public:
     /// Invalid if indexes not initialized.
     const stealth_database& stealth() const;
 
+    /// Get the wire serialized confirmed block, from the cache of recently
+    /// pushed blocks if present, otherwise streamed from the store.
+    bool get_block_data(data_chunk& out_data, const hash_digest& hash) const;
+
     // Synchronous writers.
     // ------------------------------------------------------------------------
 
@@ -103,6 +111,13 @@ public:
     /// Returns store_block_invalid_height if height is not the current top + 1.
     code push(const chain::block& block, size_t height);
 
+    /// Store a run of unconfirmed headers from first_height as one batch.
+    /// Returns store_block_missing_parent if the headers are not linked, or
+    /// the first is not linked to the top or to a header stored above it.
+    /// Returns store_block_invalid_height if the height is not that of the
+    /// parent + 1, or is at or below the current top.
+    code push(const chain::header::list& headers, size_t first_height);
+
     // Asynchronous writers.
     // ------------------------------------------------------------------------
 
@@ -130,6 +145,7 @@ protected:
 
     std::shared_ptr<block_database> blocks_;
     std::shared_ptr<transaction_database> transactions_;
+    std::shared_ptr<unspent_database> unspents_;
     std::shared_ptr<spend_database> spends_;
     std::shared_ptr<history_database> history_;
     std::shared_ptr<stealth_database> stealth_;
@@ -141,21 +157,35 @@ private:
     // Synchronous writers.
     // ------------------------------------------------------------------------
 
+    void load_cache();
+    void save_cache();
+    void cache_block(const hash_digest& hash, data_chunk&& data);
     bool push_transactions(const chain::block& block, size_t height,
         uint32_t median_time_past, size_t bucket=0, size_t buckets=1);
     bool push_heights(const chain::block& block, size_t height);
+    void push_unspents(const chain::block& block, size_t height);
+    void push_unspents(const chain::transaction::list& transactions,
+        size_t height, uint32_t median_time_past);
     void push_inputs(const hash_digest& tx_hash, size_t height,
-        const inputs& inputs);
+        const inputs& inputs, const chain::transaction::list& block_txs);
+    uint64_t get_spent(const chain::output_point& prevout, size_t height,
+        const chain::transaction::list& block_txs) const;
+    uint64_t get_spent(const chain::output_point& prevout,
+        size_t height) const;
     void push_outputs(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
 
     bool pop(chain::block& out_block);
+    bool pop_transactions(chain::block& out_block, size_t height);
     bool pop_inputs(const inputs& inputs, size_t height);
     bool pop_outputs(const outputs& outputs, size_t height);
+    bool pop_unspents(const chain::transaction& tx, size_t height);
     code verify_insert(const chain::block& block, size_t height);
     code verify_push(const chain::block& block, size_t height);
+    code verify_push(const chain::header::list& headers,
+        size_t first_height);
     code verify_push(const chain::transaction& tx);
 
     // Asynchronous writers.
@@ -181,11 +211,18 @@ private:
     std::atomic<bool> closed_;
     const settings& settings_;
 
+    // The height of the next block to apply to the unspent table.
+    size_t unspent_height_;
+    mutable shared_mutex unspent_mutex_;
+
     // Used to prevent concurrent unsafe writes.
     mutable shared_mutex write_mutex_;
 
     // Used to prevent concurrent file remapping.
     std::shared_ptr<shared_mutex> remap_mutex_;
+
+    // Serialized recently-pushed blocks, for serving peers.
+    block_cache block_cache_;
 };
 
 } // namespace database
@@ -20,14 +20,19 @@
 #define LIBBITCOIN_DATABASE_BLOCK_DATABASE_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/gap_index.hpp>
+#include <bitcoin/database/header_index.hpp>
 #include <bitcoin/database/memory/memory_map.hpp>
 #include <bitcoin/database/primitives/record_hash_table.hpp>
 #include <bitcoin/database/primitives/record_manager.hpp>
+#include <bitcoin/database/primitives/striped_mutex.hpp>
 #include <bitcoin/database/result/block_result.hpp>
+#include <bitcoin/database/short_ids.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -43,10 +48,17 @@ public:
 
     static const array_index empty;
 
+    /// The block message checksum, as stored with each full block.
+    static uint32_t checksum(const chain::block& block);
+
+    /// The block message checksum of the serialized block.
+    static uint32_t checksum(const data_chunk& data);
+
     /// Construct the database.
+    /// Optionally cache confirmed headers in memory for height queries.
     block_database(const path& map_filename, const path& block_index_filename,
         const path& tx_index_filename, size_t buckets, size_t expansion,
-        mutex_ptr mutex=nullptr);
+        bool cache_headers=false, mutex_ptr mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
     ~block_database();
@@ -66,32 +78,62 @@ public:
     /// The list of heights representing all chain gaps.
     bool gaps(heights& out_gaps) const;
 
+    /// The ranges of heights representing all chain gaps, ordered by height.
+    gap_index::ranges missing() const;
+
     /// Fetch block by height using the index table.
     block_result get(size_t height) const;
 
     /// Fetch block by hash using the hashtable.
     block_result get(const hash_digest& hash, bool require_confirmed) const;
 
+    /// Get the hash of the confirmed block at the height.
+    bool get_hash(hash_digest& out_hash, size_t height) const;
+
+    /// Get the header of the confirmed block at the height.
+    bool get_header(chain::header& out_header, size_t height) const;
+
+    /// Get up to count confirmed headers from first, stopping at a gap.
+    chain::header::list get_headers(size_t first, size_t count) const;
+
+    /// Get the lowest confirmed height with median time past at or above the
+    /// time, by binary search (median time past is monotonic by height).
+    /// False if there is no such block (e.g. the time is above the top).
+    bool get_height(size_t& out_height, uint32_t median_time_past) const;
+
+    /// Get the hashes of the confirmed blocks at the heights (in order).
+    bool get_locator(hash_list& out_hashes,
+        const chain::block::indexes& heights) const;
+
     /// This is ordered, but block parallelism may leave confirmation gaps.
     /// Store an unconfirmed header with no transactions.
     void store(const chain::header& header, size_t height);
 
+    /// Store a contiguous run of headers with no transactions from the first
+    /// height, allocating, linking and indexing (if confirmed) as one batch.
+    void store(const chain::header::list& headers, size_t first_height,
+        bool confirmed);
+
     /// This is optimized by storing tx file offsets in metadata.
     /// Store a header and associate transactions (false if any missing).
     void store(const chain::block& block, size_t height, bool confirmed);
 
-    /// TODO: optimize by storing tx file offsets in metadata.
-    /// This may come from the wire or be generated via the mining interface.
-    /// Store a header and associate transactions (false if any missing).
-    void store(const message::compact_block& compact, size_t height,
+    /// Store as above, with the checksum of the already serialized block.
+    void store(const chain::block& block, size_t height, uint32_t checksum,
         bool confirmed);
 
+    /// This may come from the wire or be generated via the mining interface.
+    /// Store an unconfirmed header and associate transaction short ids, which
+    /// must be finalized into tx offsets via update(block) before
+    /// confirmation (false if any prefilled index is invalid).
+    bool store(const message::compact_block& compact, size_t height);
+
     /// Update an existing block's transactions association.
     bool update(const chain::block& block, size_t height, bool confirmed);
 
-    /// Update an existing block's transactions association.
-    bool update(const message::compact_block& compact, size_t height,
-        bool confirmed);
+    /// Update an existing unconfirmed block's transactions association to
+    /// short ids (false if not found or any prefilled index is invalid).
+    bool update(const message::compact_block& compact, size_t height);
 
     /// Promote the block and all ancestors up to the fork point.
     /// This does not promote the block's transactions or their spends, which
@@ -114,11 +156,11 @@ public:
 
 private:
     typedef record_hash_table<hash_digest> record_map;
-    typedef message::compact_block::short_id_list short_id_list;
 
     // Associate an array of transactions for a block.
     array_index associate(const chain::transaction::list& transactions);
-    array_index associate(const short_id_list& ids);
+    bool associate(array_index& out_start,
+        const message::compact_block& compact);
 
     void store(const chain::header& header, size_t height, uint32_t checksum,
         array_index tx_start, size_t tx_count, bool confirmed);
@@ -132,8 +174,25 @@ private:
     // Write block hash table index into the block index.
     void write_index(array_index index, array_index height);
 
+    // Write a contiguous run of block hash table indexes into the block index.
+    void write_index(array_index first_index, array_index first_height,
+        size_t count);
+
     // Use block index to get block hash table index from height.
     array_index get_index(array_index height) const;
+    array_index read_index(array_index height) const;
+
+    // Read the median time past of the block record.
+    uint32_t read_median_time_past(array_index index) const;
+
+    // Read the hash and header of the block record.
+    header_index::entry read_entry(array_index index) const;
+
+    // Populate the header cache from the block index (parallel).
+    void load_headers();
+
+    // Populate the gap index from the block index.
+    void load_gaps();
 
     // The starting size of the hash table, used by create.
     const size_t initial_map_file_size_;
@@ -155,10 +214,19 @@ private:
     record_manager tx_index_manager_;
 
     // Guard against concurrent update of a range of block indexes.
+    // Lock order: index_mutex_ is always taken before any metadata stripe,
+    // and never while a stripe is held.
     mutable upgrade_mutex index_mutex_;
 
     // This provides atomicity for checksum, tx_start, tx_count, confirmed.
-    mutable shared_mutex metadata_mutex_;
+    striped_mutex metadata_mutex_;
+
+    // Missing heights, maintained with the block index (under index_mutex_).
+    gap_index gaps_;
+
+    // Confirmed headers by height, maintained with the block index.
+    const bool cache_headers_;
+    header_index headers_;
 };
 
 } // namespace database
@@ -19,12 +19,16 @@
 #ifndef LIBBITCOIN_DATABASE_HISTORY_DATABASE_HPP
 #define LIBBITCOIN_DATABASE_HISTORY_DATABASE_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/memory/memory_map.hpp>
 #include <bitcoin/database/primitives/record_multimap.hpp>
+#include <bitcoin/database/primitives/striped_mutex.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -42,6 +46,29 @@ struct BCD_API history_statinfo
     const size_t rows;
 };
 
+/// Aggregates of the history of an address, maintained with its rows.
+struct BCD_API history_summary
+{
+    /// Number of rows (outputs and spends) of the address.
+    size_t rows;
+
+    /// Total value of the output rows.
+    uint64_t received;
+
+    /// Total value of the outputs spent by the input rows (where known).
+    uint64_t spent;
+
+    /// Lowest height of any row (zero if no rows).
+    size_t min_height;
+
+    /// Highest height of any row (zero if no rows).
+    size_t max_height;
+
+    /// True if no row was stored below the height of a previous row, so
+    /// that a walk of the rows (newest first) is in descending height order.
+    bool ordered;
+};
+
 /// This is a multimap where the key is the Bitcoin address hash,
 /// which returns several rows giving the history for that address.
 class BCD_API history_database
@@ -51,6 +78,12 @@ public:
     typedef chain::payment_record::list list;
     typedef std::shared_ptr<shared_mutex> mutex_ptr;
 
+    /// Rows are visited newest first, return false to stop the walk.
+    typedef std::function<bool(const chain::payment_record&)> row_handler;
+
+    /// The cursor returned when no rows remain to be walked.
+    static const array_index end_of_history;
+
     /// Construct the database.
     history_database(const path& lookup_filename, const path& rows_filename,
         size_t buckets, size_t expansion, mutex_ptr mutex=nullptr);
@@ -70,11 +103,32 @@ public:
     /// Get the output and input points associated with the address hash.
     list get(const short_hash& key, size_t limit, size_t from_height) const;
 
+    /// Visit up to limit rows (zero for unlimited) of the address hash at or
+    /// above from_height. If the rows of the address were stored in height
+    /// order the walk ends at the first row below from_height, otherwise
+    /// lower rows are skipped. Returns the opaque cursor from which to resume
+    /// the walk, or end_of_history if there are no more rows.
+    array_index get(const short_hash& key, size_t limit, size_t from_height,
+        row_handler handler) const;
+
+    /// Resume a walk from a cursor returned by a previous walk.
+    /// The cursor does not identify the address, so lower rows are skipped.
+    /// A cursor is invalidated by a reorganization (or any unlink), and one
+    /// that is not a row index returns end_of_history.
+    array_index get(array_index cursor, size_t limit, size_t from_height,
+        row_handler handler) const;
+
+    /// Get the summary of the address hash, O(1).
+    history_summary get_summary(const short_hash& key) const;
+
     /// Add a row for the key. If key doesn't exist it will be created.
-    void store(const short_hash& key, const chain::payment_record& payment);
+    /// The spent value is the value of the output spent by an input row.
+    void store(const short_hash& key, const chain::payment_record& payment,
+        uint64_t spent=0);
 
     /// Logically delete the last row that was added to key.
-    bool unlink_last_row(const short_hash& key);
+    /// The spent value must match that with which an input row was stored.
+    bool unlink_last_row(const short_hash& key, uint64_t spent=0);
 
     /// Commit latest inserts.
     void synchronize();
@@ -102,6 +156,16 @@ private:
     memory_map rows_file_;
     record_manager rows_manager_;
     record_multiple_map rows_multimap_;
+
+    // Visit rows from the index, ending at a lower row only if ordered.
+    array_index walk(array_index cursor, size_t limit, size_t from_height,
+        bool ordered, row_handler handler) const;
+
+    // Read the lowest and highest heights of the rows from the index.
+    void scan_heights(history_summary& summary, array_index index) const;
+
+    // This provides atomicity for the summary with its rows, by key.
+    striped_mutex summary_mutex_;
 };
 
 } // namespace database
@@ -21,14 +21,19 @@
 
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/memory/memory_map.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
+#include <bitcoin/database/primitives/hash_set.hpp>
 #include <bitcoin/database/primitives/slab_hash_table.hpp>
 #include <bitcoin/database/primitives/slab_manager.hpp>
+#include <bitcoin/database/primitives/striped_mutex.hpp>
+#include <bitcoin/database/result/block_result.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
+#include <bitcoin/database/short_ids.hpp>
 #include <bitcoin/database/unspent_outputs.hpp>
 
 namespace libbitcoin {
@@ -39,6 +44,9 @@ namespace database {
 /// that is assigned upon storage.
 /// This is so we can quickly reconstruct blocks given a list of tx indexes
 /// belonging to that block. These are stored with the block.
+/// Unconfirmed (pool) transactions are stored in a separate table and are
+/// migrated to the confirmed table when confirmed, keeping it dense.
+/// The hashes of all unconfirmed transactions are indexed for enumeration.
 class BCD_API transaction_database
 {
 public:
@@ -49,9 +57,13 @@ public:
     /// Sentinel for use in tx position to indicate unconfirmed.
     static const size_t unconfirmed;
 
-    /// Construct the database.
-    transaction_database(const path& map_filename, size_t buckets,
-        size_t expansion, size_t cache_capacity, mutex_ptr mutex=nullptr);
+    /// Construct the database (the output cache is limited to cache_bytes).
+    /// Compression must not change for the life of the store.
+    transaction_database(const path& map_filename, const path& pool_filename,
+        const path& pool_index_filename, size_t buckets, size_t pool_buckets,
+        size_t expansion, size_t cache_bytes,
+        eviction_policy cache_policy=eviction_policy::fifo,
+        bool compress=false, mutex_ptr mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
     ~transaction_database();
@@ -65,19 +77,63 @@ public:
     /// Call to unload the memory map.
     bool close();
 
-    /// Fetch transaction by file offset.
+    /// Fetch confirmed table transaction by file offset.
     transaction_result get(file_offset hash) const;
 
     /// Fetch transaction by its hash, at or below the specified block height.
     transaction_result get(const hash_digest& hash, size_t fork_height,
         bool require_confirmed) const;
 
+    /// Stream the wire serialized transaction from the store, without parse.
+    bool get_data(writer& sink, const hash_digest& hash, size_t fork_height,
+        bool require_confirmed) const;
+
+    /// Copy the wire serialized transaction into the buffer, without parse.
+    /// The buffer is resized to fit, so its capacity may be reused.
+    bool get_data(data_chunk& out_data, const hash_digest& hash,
+        size_t fork_height, bool require_confirmed) const;
+
+    /// Fetch the transactions of the block in block order, walking its tx
+    /// offsets in place. Empty if the block is compact or any is missing.
+    transaction_result::list get_transactions(const block_result& block) const;
+
+    /// Stream the wire serialized block from the store, without parse.
+    /// False if the block is compact or any transaction is missing.
+    bool get_block_data(writer& sink, const block_result& block) const;
+
+    /// The hashes of all unconfirmed transactions (snapshot).
+    hash_list unconfirmed_hashes() const;
+
+    /// The number of unconfirmed transactions.
+    size_t unconfirmed_count() const;
+
+    /// Resolve compact block short ids to unconfirmed tx hashes, setting
+    /// null_hash where not found or ambiguous. Returns the number resolved.
+    /// The pool short ids are computed once per key and then maintained.
+    size_t resolve(hash_list& out_hashes, const short_id_list& ids,
+        const siphash_key& key) const;
+
     /// Get the output at the specified index within the transaction.
     bool get_output(chain::output& out_output, size_t& out_height,
         uint32_t& out_median_time_past, bool& out_coinbase,
         const chain::output_point& point, size_t fork_height,
         bool require_confirmed) const;
 
+    /// Populate the validation cache of the prevouts of all block inputs.
+    /// Cache misses are read in ascending file offset order, so that large
+    /// blocks incur mostly sequential reads. Returns the number populated.
+    size_t get_outputs(const chain::block& block, size_t fork_height,
+        bool require_confirmed) const;
+
+    /// Write the output cache to a snapshot file tagged by the top block.
+    bool save_cache(const path& filename, const hash_digest& top) const;
+
+    /// Load an output cache snapshot tagged by the top block (then removed).
+    bool load_cache(const path& filename, const hash_digest& top);
+
+    /// Add the outputs of a confirmed block to the output cache.
+    void warm_cache(const block_result& block);
+
     /// Store a set of transactions presumed to be associated to a block.
     file_offset associate(const chain::transaction::list& transactions);
 
@@ -92,12 +148,18 @@ public:
     bool unspend(const chain::output_point& point);
 
     /// Promote an unconfirmed tx (not including its indexes).
+    /// A pool transaction is moved to the confirmed table.
     file_offset confirm(const hash_digest& hash, size_t height,
         uint32_t median_time_past, size_t position);
 
     /// Demote the transaction.
     bool unconfirm(const hash_digest& hash);
 
+    /// Rewrite the pool table without the slabs of migrated txs, as pool
+    /// slabs are not otherwise reclaimed. Call only at open, under the write
+    /// (flush) lock, as the table is rewritten in place.
+    bool compact_pool();
+
     /// Commit latest inserts.
     void synchronize();
 
@@ -105,11 +167,23 @@ public:
     bool flush() const;
 
 private:
+    typedef std::unordered_multimap<uint64_t, hash_digest> short_id_map;
+
+    void index_pool(const hash_digest& hash);
+    void unindex_pool(const hash_digest& hash);
+
     memory_ptr find(const hash_digest& hash, size_t maximum_height,
         bool require_confirmed) const;
+    bool is_coinbase(const hash_digest& hash) const;
+    file_offset migrate(const hash_digest& hash, size_t height,
+        uint32_t median_time_past, size_t position);
 
-    // The starting size of the hash table, used by create.
+    // The starting size of the hash tables, used by create.
     const size_t initial_map_file_size_;
+    const size_t initial_pool_file_size_;
+
+    // Outputs are stored with compressed amounts and scripts.
+    const bool compress_;
 
     // Hash table used for looking up txs by hash.
     memory_map lookup_file_;
@@ -117,11 +191,30 @@ private:
     slab_manager lookup_manager_;
     slab_map lookup_map_;
 
+    // Hash table used for looking up unconfirmed txs by hash.
+    memory_map pool_file_;
+    slab_hash_table_header pool_header_;
+    slab_manager pool_manager_;
+    slab_map pool_map_;
+
+    // Guard against concurrent unlink of migrated pool txs.
+    shared_mutex pool_mutex_;
+
+    // Set of unconfirmed tx hashes, in either table.
+    memory_map pool_index_file_;
+    hash_set pool_index_;
+
+    // Short ids of the unconfirmed txs under the last resolved key (cache).
+    mutable bool short_ids_keyed_;
+    mutable siphash_key short_ids_key_;
+    mutable short_id_map short_ids_;
+    mutable shared_mutex short_ids_mutex_;
+
     // This is thread safe, and as a cache is mutable.
     mutable unspent_outputs cache_;
 
-    // This provides atomicity for height and position.
-    mutable shared_mutex metadata_mutex_;
+    // This provides atomicity for height and position (striped by hash).
+    striped_mutex metadata_mutex_;
 };
 
 } // namespace database
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_UNSPENT_DATABASE_HPP
+#define LIBBITCOIN_DATABASE_UNSPENT_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory/memory_map.hpp>
+#include <bitcoin/database/primitives/slab_hash_table.hpp>
+#include <bitcoin/database/primitives/slab_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This enables lookup of the confirmed unspent outputs by output point.
+/// Only outputs of the strong chain are present, so this is the compact
+/// working set of validation, independent of the transaction table.
+class BCD_API unspent_database
+{
+public:
+    typedef boost::filesystem::path path;
+    typedef std::shared_ptr<shared_mutex> mutex_ptr;
+
+    /// Construct the database.
+    unspent_database(const path& filename, size_t buckets, size_t expansion,
+        mutex_ptr mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~unspent_database();
+
+    /// Initialize a new unspent database.
+    bool create();
+
+    /// Call before using the database.
+    bool open();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Get the output if unspent at the top of the contiguous chain.
+    /// Provably unspendable outputs are never stored, so are not found.
+    bool get(chain::output& out_output, size_t& out_height,
+        uint32_t& out_median_time_past, bool& out_coinbase,
+        const chain::output_point& point) const;
+
+    /// Store all spendable outputs of a confirmed transaction.
+    void store(const chain::transaction& tx, size_t height,
+        uint32_t median_time_past);
+
+    /// Store a single output (restores a spent output on reorganization).
+    void store(const chain::output_point& point, const chain::output& output,
+        size_t height, uint32_t median_time_past, bool coinbase);
+
+    /// Delete the output from the database (spent or reorganized out).
+    bool unlink(const chain::output_point& point);
+
+    /// Commit latest inserts.
+    void synchronize();
+
+    /// Flush the memory map to disk.
+    bool flush() const;
+
+private:
+    typedef slab_hash_table<chain::point> slab_map;
+
+    // The starting size of the hash table, used by create.
+    const size_t initial_map_file_size_;
+
+    // Hash table used for looking up unspent outputs by outpoint.
+    memory_map lookup_file_;
+    slab_hash_table_header lookup_header_;
+    slab_manager lookup_manager_;
+    slab_map lookup_map_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_GAP_INDEX_HPP
+#define LIBBITCOIN_DATABASE_GAP_INDEX_HPP
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// An in-memory set of disjoint ranges of heights missing from the block
+/// index (gaps), which is maintained as heights are written and truncated.
+class BCD_API gap_index
+  : noncopyable
+{
+public:
+    typedef std::vector<size_t> heights;
+
+    /// A run of missing heights [first, first + count).
+    struct range
+    {
+        size_t first;
+        size_t count;
+    };
+
+    typedef std::vector<range> ranges;
+
+    /// The number of disjoint ranges.
+    size_t size() const;
+
+    /// The number of missing heights.
+    size_t count() const;
+
+    /// Remove all ranges.
+    void clear();
+
+    /// Mark the heights as missing, merging with adjacent ranges.
+    void insert(size_t first, size_t count);
+
+    /// Mark the heights as present, splitting ranges as necessary.
+    void erase(size_t first, size_t count);
+
+    /// Remove all missing heights at and above the height.
+    void truncate(size_t height);
+
+    /// The lowest height at or above the height that is not missing.
+    size_t next(size_t height) const;
+
+    /// Get the missing ranges, ordered by height.
+    ranges get() const;
+
+    /// Append each missing height to the list, ordered by height.
+    void get(heights& out_heights) const;
+
+private:
+    typedef std::map<size_t, size_t> range_map;
+
+    // Remove [first, end) from the map (caller must hold exclusive lock).
+    void remove(size_t first, size_t end);
+
+    // Ranges are keyed by first height with a value of the end (exclusive).
+    range_map ranges_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
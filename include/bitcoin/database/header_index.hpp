@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_HEADER_INDEX_HPP
+#define LIBBITCOIN_DATABASE_HEADER_INDEX_HPP
+
+#include <cstddef>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A contiguous in-memory array of confirmed block headers by height.
+/// Heights without a confirmed block (gaps) have a null hash.
+class BCD_API header_index
+  : noncopyable
+{
+public:
+    typedef byte_array<80> header_data;
+
+    struct entry
+    {
+        hash_digest hash;
+        header_data header;
+    };
+
+    typedef std::vector<entry> list;
+
+    /// The number of heights in the index, including gaps.
+    size_t size() const;
+
+    /// Replace the index (entries are ordered by height).
+    void assign(list&& entries);
+
+    /// Set the entry at the height, creating gaps as necessary.
+    void set(size_t height, const entry& value);
+
+    /// Remove all entries at and above the height.
+    void truncate(size_t height);
+
+    /// Get the entry at the height, false if a gap or above the top.
+    bool get(entry& out_entry, size_t height) const;
+
+    /// Get the hash at the height, false if a gap or above the top.
+    bool get(hash_digest& out_hash, size_t height) const;
+
+    /// Deserialize the header of the entry.
+    static chain::header to_header(const entry& value);
+
+private:
+    list entries_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_RECORD_CLUSTER_MULTIMAP_IPP
+#define LIBBITCOIN_DATABASE_RECORD_CLUSTER_MULTIMAP_IPP
+
+#include <algorithm>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/primitives/record_cluster_iterator.hpp>
+#include <bitcoin/database/primitives/record_list.hpp>
+
+// Cluster format [(rows + 1) records]:
+// ----------------------------------------------------------------------------
+// [ next:4    - const] (older cluster, or empty)
+// [ rows:4    - const] (capacity, padded to the record size)
+// [ row[0]    - const]
+// ...
+// [ row[rows - 1]    ]
+
+// Lookup format:
+// ----------------------------------------------------------------------------
+// [ cluster:4 - atomic] (newest cluster)
+// [ rows:4    - atomic] (rows in use in the newest cluster)
+
+namespace libbitcoin {
+namespace database {
+
+template <typename KeyType>
+record_cluster_multimap<KeyType>::record_cluster_multimap(
+    record_hash_table_type& map, record_manager& manager, size_t initial_rows,
+    size_t maximum_rows)
+  : map_(map), manager_(manager),
+    initial_rows_(std::max(initial_rows, size_t(1))),
+    maximum_rows_(std::max(maximum_rows, initial_rows_))
+{
+}
+
+template <typename KeyType>
+void record_cluster_multimap<KeyType>::store(const KeyType& key,
+    write_function write)
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(create_mutex_);
+
+    array_index cluster;
+    array_index rows;
+
+    if (!read_head(cluster, rows, key))
+    {
+        // Allocate and populate the first cluster before linking the key.
+        cluster = create_cluster(record_list::empty, initial_rows_);
+        write_row(cluster + 1, write);
+
+        map_.store(key, [=](serializer<uint8_t*>& serial)
+        {
+            //*****************************************************************
+            serial.template write_little_endian<array_index>(cluster);
+            serial.template write_little_endian<array_index>(1);
+            //*****************************************************************
+        });
+
+        return;
+    }
+
+    const auto capacity = read_capacity(cluster);
+
+    // Populate the next unused row, unreachable until the count is updated.
+    if (rows < capacity)
+    {
+        write_row(cluster + rows + 1, write);
+        write_head(key, cluster, rows + 1);
+        return;
+    }
+
+    // Allocate and populate a larger cluster linked to the full cluster.
+    const auto next = std::min(size_t(capacity) * 2, maximum_rows_);
+    const auto head = create_cluster(cluster, std::max(next, initial_rows_));
+    write_row(head + 1, write);
+    write_head(key, head, 1);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename KeyType>
+record_cluster_iterator record_cluster_multimap<KeyType>::find(
+    const KeyType& key) const
+{
+    array_index cluster;
+    array_index rows;
+
+    if (!read_head(cluster, rows, key))
+        return end();
+
+    return record_cluster_iterator(manager_, cluster, rows);
+}
+
+template <typename KeyType>
+record_cluster_iterator record_cluster_multimap<KeyType>::end() const
+{
+    return record_cluster_iterator(manager_, record_list::empty, 0);
+}
+
+template <typename KeyType>
+memory_ptr record_cluster_multimap<KeyType>::get(array_index index) const
+{
+    return manager_.get(index);
+}
+
+// Unlink is not safe for concurrent write.
+template <typename KeyType>
+bool record_cluster_multimap<KeyType>::unlink(const KeyType& key)
+{
+    array_index cluster;
+    array_index rows;
+
+    // No rows exist.
+    if (!read_head(cluster, rows, key))
+        return false;
+
+    // Skip the newest row of the newest cluster.
+    if (rows > 1)
+    {
+        write_head(key, cluster, rows - 1);
+        return true;
+    }
+
+    array_index next;
+    {
+        const auto memory = manager_.get(cluster);
+        next = from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory));
+    }
+
+    // Remove the hash table entry, which delinks the single row.
+    if (next == record_list::empty)
+        return map_.unlink(key);
+
+    // Skip the emptied cluster, the next cluster is full.
+    write_head(key, next, read_capacity(next));
+    return true;
+}
+
+// private
+// ----------------------------------------------------------------------------
+
+template <typename KeyType>
+bool record_cluster_multimap<KeyType>::read_head(array_index& out_cluster,
+    array_index& out_rows, const KeyType& key) const
+{
+    const auto memory = map_.find(key);
+
+    if (!memory)
+        return false;
+
+    auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(memory));
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(update_mutex_);
+    out_cluster = deserial.read_4_bytes_little_endian();
+    out_rows = deserial.read_4_bytes_little_endian();
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename KeyType>
+void record_cluster_multimap<KeyType>::write_head(const KeyType& key,
+    array_index cluster, array_index rows)
+{
+    map_.update(key, [=](serializer<uint8_t*>& serial)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(update_mutex_);
+        serial.template write_little_endian<array_index>(cluster);
+        serial.template write_little_endian<array_index>(rows);
+        ///////////////////////////////////////////////////////////////////////
+    });
+}
+
+template <typename KeyType>
+array_index record_cluster_multimap<KeyType>::read_capacity(
+    array_index cluster) const
+{
+    auto memory = manager_.get(cluster);
+    REMAP_INCREMENT(memory, sizeof(array_index));
+    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory));
+}
+
+template <typename KeyType>
+array_index record_cluster_multimap<KeyType>::create_cluster(
+    array_index next, size_t rows)
+{
+    BITCOIN_ASSERT(rows < max_uint32);
+    const auto cluster = manager_.new_records(rows + 1);
+
+    const auto memory = manager_.get(cluster);
+    auto serial = make_unsafe_serializer(REMAP_ADDRESS(memory));
+    serial.template write_little_endian<array_index>(next);
+    serial.template write_little_endian<array_index>(
+        static_cast<array_index>(rows));
+    return cluster;
+}
+
+template <typename KeyType>
+void record_cluster_multimap<KeyType>::write_row(array_index index,
+    write_function write)
+{
+    const auto memory = manager_.get(index);
+    auto serial = make_unsafe_serializer(REMAP_ADDRESS(memory));
+    serial.write_delegated(write);
+}
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
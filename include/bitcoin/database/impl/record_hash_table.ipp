@@ -68,6 +68,47 @@ array_index record_hash_table<KeyType>::store(const KeyType& key,
     return index;
 }
 
+// Records are allocated together, so they are contiguous and can be indexed
+// by position. Population is unguarded as the records are not yet linked.
+template <typename KeyType>
+array_index record_hash_table<KeyType>::store(const key_list& keys,
+    batch_function write)
+{
+    if (keys.empty())
+        return not_found;
+
+    const auto first = manager_.new_records(keys.size());
+
+    for (size_t position = 0; position < keys.size(); ++position)
+    {
+        const auto populate = [&](byte_serializer& serial)
+        {
+            write(serial, position);
+        };
+
+        const auto index = static_cast<array_index>(first + position);
+        record_row<KeyType>(manager_, index).populate(keys[position],
+            populate);
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    create_mutex_.lock();
+
+    for (size_t position = 0; position < keys.size(); ++position)
+    {
+        const auto& key = keys[position];
+        const auto index = static_cast<array_index>(first + position);
+        record_row<KeyType>(manager_, index).link(read_bucket_value(key));
+        link(key, index);
+    }
+
+    create_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return first;
+}
+
 // Execute a writer against a key's buffer if the key is found.
 // Return the array index of the found value (or not_found).
 template <typename KeyType>
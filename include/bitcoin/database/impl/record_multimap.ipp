@@ -27,8 +27,8 @@ namespace database {
 
 template <typename KeyType>
 record_multimap<KeyType>::record_multimap(record_hash_table_type& map,
-    record_manager& manager)
-  : map_(map), manager_(manager)
+    record_manager& manager, size_t summary_size)
+  : map_(map), manager_(manager), summary_size_(summary_size)
 {
 }
 
@@ -56,6 +56,9 @@ void record_multimap<KeyType>::store(const KeyType& key,
             //*****************************************************************
             serial.template write_little_endian<array_index>(begin);
             //*****************************************************************
+
+            for (size_t byte = 0; byte < summary_size_; ++byte)
+                serial.write_byte(0);
         });
     }
     else
@@ -97,6 +100,18 @@ memory_ptr record_multimap<KeyType>::get(array_index index) const
     return record.data();
 }
 
+template <typename KeyType>
+memory_ptr record_multimap<KeyType>::summary(const KeyType& key) const
+{
+    auto memory = map_.find(key);
+
+    if (!memory)
+        return nullptr;
+
+    REMAP_INCREMENT(memory, sizeof(array_index));
+    return memory;
+}
+
 // Unlink is not safe for concurrent write.
 template <typename KeyType>
 bool record_multimap<KeyType>::unlink(const KeyType& key)
@@ -55,6 +55,9 @@ public:
     /// Allocate and populate a new record.
     array_index create(const KeyType& key, write_function write);
 
+    /// Populate a record allocated via record_manager::new_records.
+    void populate(const KeyType& key, write_function write);
+
     /// Link allocated/populated record.
     void link(array_index next);
 
@@ -114,6 +117,23 @@ array_index record_row<KeyType>::create(const KeyType& key,
     return index_;
 }
 
+template <typename KeyType>
+void record_row<KeyType>::populate(const KeyType& key, write_function write)
+{
+    BITCOIN_ASSERT(index_ != bc::max_uint32);
+
+    // Populate the key and data of an existing unlinked record.
+    //   [ KeyType  ] <==
+    //   [ next:4   ]
+    //   [ value... ] <==
+    const auto memory = raw_data(key_start);
+    const auto record = REMAP_ADDRESS(memory);
+    auto serial = make_unsafe_serializer(record);
+    serial.write_forward(key);
+    serial.skip(index_size);
+    serial.write_delegated(write);
+}
+
 template <typename KeyType>
 void record_row<KeyType>::link(array_index next)
 {
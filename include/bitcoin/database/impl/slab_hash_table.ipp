@@ -126,6 +126,32 @@ memory_ptr slab_hash_table<KeyType>::find(const KeyType& key) const
     return nullptr;
 }
 
+// This is limited to returning the first of multiple matching key values.
+template <typename KeyType>
+file_offset slab_hash_table<KeyType>::offset(const KeyType& key) const
+{
+    // Find start item...
+    auto current = read_bucket_value(key);
+
+    // Iterate through list...
+    while (current != not_found)
+    {
+        const slab_row<KeyType> item(manager_, current);
+
+        // Found, return position.
+        if (item.compare(key))
+            return item.offset();
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(update_mutex_);
+        current = item.next_position();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return not_found;
+}
+
 // Unlink is not safe for concurrent write.
 // This is limited to unlinking the first of multiple matching key values.
 template <typename KeyType>
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_HASH_SET_HPP
+#define LIBBITCOIN_DATABASE_HASH_SET_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory/memory_map.hpp>
+#include <bitcoin/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A persistent set of hashes stored as a dense array of records, supporting
+/// constant time insert, remove (swap with last) and ordered enumeration.
+/// Record positions are cached in memory and rebuilt from the file on start.
+class BCD_API hash_set
+  : noncopyable
+{
+public:
+    hash_set(memory_map& file);
+
+    /// Create hash set.
+    bool create();
+
+    /// Prepare set for usage (reads all hashes).
+    bool start();
+
+    /// Synchronise to disk.
+    void sync();
+
+    /// The number of hashes in the set.
+    size_t size() const;
+
+    /// True if the hash is in the set.
+    bool contains(const hash_digest& hash) const;
+
+    /// Add the hash to the set, false if already present.
+    bool insert(const hash_digest& hash);
+
+    /// Remove the hash from the set, false if not present.
+    bool remove(const hash_digest& hash);
+
+    /// A snapshot of the hashes in the set.
+    hash_list hashes() const;
+
+private:
+    typedef std::unordered_map<hash_digest, array_index> position_map;
+
+    hash_digest read(array_index index) const;
+    void write(array_index index, const hash_digest& hash);
+
+    record_manager manager_;
+    position_map positions_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_RECORD_CLUSTER_MULTIMAP_HPP
+#define LIBBITCOIN_DATABASE_RECORD_CLUSTER_MULTIMAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/primitives/record_cluster_iterator.hpp>
+#include <bitcoin/database/primitives/record_hash_table.hpp>
+#include <bitcoin/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+inline size_t cluster_multimap_record_size(size_t value_size)
+{
+    // Rows have no next pointer, but a record must also fit a header.
+    return std::max(value_size, record_cluster_iterator::header_size);
+}
+
+template <typename KeyType>
+BC_CONSTEXPR size_t hash_table_cluster_multimap_record_size()
+{
+    // The hash table maps a key to the head cluster and its row count.
+    return hash_table_record_size<KeyType>(2 * sizeof(array_index));
+}
+
+/**
+ * A multimap hashtable where each key has multiple values, with the rows
+ * of a key allocated in contiguous clusters rather than individually.
+ * The first cluster of a key holds the initial number of rows, and each
+ * subsequent cluster twice that of its predecessor (up to the maximum).
+ * Clusters are linked newest first, so the rows of a key occupy a number
+ * of contiguous regions logarithmic in its row count. Unlinked rows of the
+ * newest cluster are reused by the next store, unlinked clusters are not.
+ */
+template <typename KeyType>
+class record_cluster_multimap
+{
+public:
+    typedef serializer<uint8_t*>::functor write_function;
+    typedef record_hash_table<KeyType> record_hash_table_type;
+
+    record_cluster_multimap(record_hash_table_type& map,
+        record_manager& manager, size_t initial_rows=4,
+        size_t maximum_rows=1024);
+
+    /// Add a new row for a key.
+    void store(const KeyType& key, write_function write);
+
+    /// Iterator to the newest row of the key, or end() if not found.
+    record_cluster_iterator find(const KeyType& key) const;
+
+    /// Iterator past the oldest row of any key.
+    record_cluster_iterator end() const;
+
+    /// Get a remap safe address pointer to the indexed data.
+    memory_ptr get(array_index index) const;
+
+    /// Delete the last row that was added for the key.
+    bool unlink(const KeyType& key);
+
+private:
+    bool read_head(array_index& out_cluster, array_index& out_rows,
+        const KeyType& key) const;
+    void write_head(const KeyType& key, array_index cluster,
+        array_index rows);
+    array_index read_capacity(array_index cluster) const;
+    array_index create_cluster(array_index next, size_t rows);
+    void write_row(array_index index, write_function write);
+
+    record_hash_table_type& map_;
+    record_manager& manager_;
+    const size_t initial_rows_;
+    const size_t maximum_rows_;
+    mutable shared_mutex create_mutex_;
+    mutable shared_mutex update_mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#include <bitcoin/database/impl/record_cluster_multimap.ipp>
+
+#endif
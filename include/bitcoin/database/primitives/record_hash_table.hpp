@@ -21,7 +21,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <tuple>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/primitives/hash_table_header.hpp>
@@ -62,7 +64,9 @@ class record_hash_table
 {
 public:
     typedef KeyType key_type;
+    typedef std::vector<KeyType> key_list;
     typedef byte_serializer::functor write_function;
+    typedef std::function<void(byte_serializer&, size_t)> batch_function;
 
     static const array_index not_found;
 
@@ -72,6 +76,12 @@ public:
     /// number of bytes (record_size - key_size - sizeof(array_index)).
     array_index store(const KeyType& key, write_function write);
 
+    /// Execute a write for each key into one contiguous allocation, linking
+    /// all records under a single lock. The write function is passed the
+    /// position of the key. Returns the array index of the first record, with
+    /// each subsequent record at the next index (or not_found if empty).
+    array_index store(const key_list& keys, batch_function write);
+
     /// Execute a writer against a key's buffer if the key is found.
     /// Returns the array index of the found value (or zero).
     array_index update(const KeyType& key, write_function write);
@@ -36,10 +36,11 @@ inline size_t multimap_record_size(size_t value_size)
 }
 
 template <typename KeyType>
-BC_CONSTEXPR size_t hash_table_multimap_record_size()
+BC_CONSTEXPR size_t hash_table_multimap_record_size(size_t summary_size=0)
 {
-    // The hash table maps a key only to the first record index.
-    return hash_table_record_size<KeyType>(sizeof(array_index));
+    // The hash table maps a key to the first record index and a summary.
+    return hash_table_record_size<KeyType>(sizeof(array_index) +
+        summary_size);
 }
 
 /**
@@ -49,7 +50,8 @@ BC_CONSTEXPR size_t hash_table_multimap_record_size()
  * The database is abstracted on top of a record map, and linked records.
  * The map links keys to start indexes in the linked records.
  * The linked records are chains of records that can be iterated through
- * given a start index.
+ * given a start index. Each key may also carry a fixed size summary, which
+ * is zeroed when the key is created and otherwise maintained by the caller.
  */
 template <typename KeyType>
 class record_multimap
@@ -58,7 +60,8 @@ public:
     typedef serializer<uint8_t*>::functor write_function;
     typedef record_hash_table<KeyType> record_hash_table_type;
 
-    record_multimap(record_hash_table_type& map, record_manager& manager);
+    record_multimap(record_hash_table_type& map, record_manager& manager,
+        size_t summary_size=0);
 
     /// Add a new row for a key.
     void store(const KeyType& key, write_function write);
@@ -69,12 +72,17 @@ public:
     /// Get a remap safe address pointer to the indexed data.
     memory_ptr get(array_index index) const;
 
+    /// Get a remap safe address pointer to the summary of the key.
+    /// Returns a null pointer if the key has no rows.
+    memory_ptr summary(const KeyType& key) const;
+
     /// Delete the last row that was added for the key.
     bool unlink(const KeyType& key);
 
 private:
     record_hash_table_type& map_;
     record_manager& manager_;
+    const size_t summary_size_;
     mutable shared_mutex create_mutex_;
     mutable shared_mutex update_mutex_;
 };
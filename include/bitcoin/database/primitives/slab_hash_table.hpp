@@ -74,6 +74,9 @@ public:
     /// Find the slab for a given key. Returns a null pointer if not found.
     memory_ptr find(const KeyType& key) const;
 
+    /// Find the file offset of the value for a given key (or not_found).
+    file_offset offset(const KeyType& key) const;
+
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
@@ -48,6 +48,9 @@ public:
     /// Prepare manager for use.
     bool start();
 
+    /// Discard all slabs, shrinking the file (no slab may be accessed).
+    void clear();
+
     /// Synchronise the payload size to disk.
     void sync() const;
 
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_STRIPED_MUTEX_HPP
+#define LIBBITCOIN_DATABASE_STRIPED_MUTEX_HPP
+
+#include <cstddef>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// This class is thread safe.
+/// A fixed set of shared mutexes selected by record key, so that readers and
+/// writers of unrelated records do not contend on a common lock.
+class BCD_API striped_mutex
+  : noncopyable
+{
+public:
+    /// The default number of stripes.
+    static const size_t default_stripes;
+
+    /// Construct the set of mutexes (stripes must be nonzero).
+    striped_mutex(size_t stripes=default_stripes);
+
+    /// The number of stripes.
+    size_t size() const;
+
+    /// The mutex that guards records of the specified key.
+    shared_mutex& get(const hash_digest& key) const;
+
+    /// The mutex that guards records of the specified key.
+    shared_mutex& get(const short_hash& key) const;
+
+    /// Exclusively lock all stripes (in order), for writes over many keys.
+    void lock() const;
+
+    /// Unlock all stripes locked by lock().
+    void unlock() const;
+
+private:
+    mutable std::vector<shared_mutex> mutexes_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
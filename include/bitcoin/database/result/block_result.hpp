@@ -25,6 +25,8 @@
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/primitives/record_manager.hpp>
+#include <bitcoin/database/result/offset_iterable.hpp>
+#include <bitcoin/database/short_ids.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -69,6 +71,9 @@ public:
     /// The header.timestamp of this block.
     uint32_t timestamp() const;
 
+    /// The median time past of this block (as stored with the header).
+    uint32_t median_time_past() const;
+
     /// The header.version of this block.
     uint32_t version() const;
 
@@ -78,10 +83,20 @@ public:
     /// The number of transactions in this block (may be zero).
     size_t transaction_count() const;
 
-    /// Get the set of transaction offsets into the tx table for the block.
-    offset_list transaction_offsets() const;
+    /// True if transactions are associated as short ids (not yet resolved).
+    bool compact() const;
+
+    /// Iterate the transaction offsets into the tx table for the block, in
+    /// place in the tx index (no copy). Empty if the block is compact.
+    offset_iterable transaction_offsets() const;
+
+    /// Get the set of transaction short ids for the block.
+    /// Empty if the block is not compact.
+    short_id_list short_ids() const;
 
 private:
+    offset_list read_slots() const;
+
     memory_ptr record_;
     const hash_digest hash_;
     const uint32_t height_;
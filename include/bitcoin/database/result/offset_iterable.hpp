@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_OFFSET_ITERABLE_HPP
+#define LIBBITCOIN_DATABASE_OFFSET_ITERABLE_HPP
+
+#include <cstddef>
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/result/offset_iterator.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A container wrapper allowing mapped file offsets to be iterated in place,
+/// without copying. The remap lock is held until this object is destroyed.
+class BCD_API offset_iterable
+{
+public:
+    /// Construct an empty iterable.
+    offset_iterable();
+
+    /// Construct an iterable over count offsets starting at memory.
+    offset_iterable(memory_ptr memory, size_t count);
+
+    /// The number of offsets.
+    size_t size() const;
+
+    /// True if there are no offsets.
+    bool empty() const;
+
+    offset_iterator begin() const;
+    offset_iterator end() const;
+
+private:
+    memory_ptr memory_;
+    size_t count_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
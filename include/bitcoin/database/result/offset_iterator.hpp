@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_OFFSET_ITERATOR_HPP
+#define LIBBITCOIN_DATABASE_OFFSET_ITERATOR_HPP
+
+#include <cstdint>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Forward iterator over contiguous mapped 8 byte file offsets.
+/// The memory must remain mapped (remap lock held) for the iterator lifetime.
+class BCD_API offset_iterator
+{
+public:
+    offset_iterator(const uint8_t* position);
+
+    /// Next offset in the array.
+    void operator++();
+
+    /// The file offset.
+    file_offset operator*() const;
+
+    /// Comparison operators.
+    bool operator==(offset_iterator other) const;
+    bool operator!=(offset_iterator other) const;
+
+private:
+    const uint8_t* position_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
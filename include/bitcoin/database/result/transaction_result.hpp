@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/define.hpp>
 #include <bitcoin/database/memory/memory.hpp>
@@ -29,15 +30,21 @@ namespace libbitcoin {
 namespace database {
 
 /// Deferred read transaction result.
+/// Lazy accessors read the mapped slab, which remains valid (the remap lock
+/// is held) until this result is reset or destroyed.
 class BCD_API transaction_result
 {
 public:
+    typedef std::vector<transaction_result> list;
+
     transaction_result();
     transaction_result(memory_ptr slab);
     transaction_result(memory_ptr slab, hash_digest&& hash,
-        uint32_t height, uint32_t median_time_past, uint16_t position);
+        uint32_t height, uint32_t median_time_past, uint16_t position,
+        bool compressed=false);
     transaction_result(memory_ptr slab, const hash_digest& hash,
-        uint32_t height, uint32_t median_time_past, uint16_t position);
+        uint32_t height, uint32_t median_time_past, uint16_t position,
+        bool compressed=false);
 
     /// True if this transaction result is valid (found).
     operator bool() const;
@@ -63,17 +70,49 @@ public:
     /// True if all transaction outputs are spent at or below fork_height.
     bool is_spent(size_t fork_height) const;
 
+    /// The number of inputs in this transaction (read from slab).
+    size_t input_count() const;
+
+    /// The number of outputs in this transaction (read from slab).
+    size_t output_count() const;
+
+    /// The value of the output at the index (output::not_found if invalid).
+    uint64_t output_value(uint32_t index) const;
+
+    /// True if outputs are stored in compressed form.
+    bool compressed() const;
+
+    /// The script bytes of the output at the index, in place in the slab.
+    /// Empty if invalid or compressed, in which case use output_script_data.
+    data_slice output_script(uint32_t index) const;
+
+    /// A copy of the script bytes of the output at the index, in either
+    /// storage form (empty if invalid).
+    data_chunk output_script_data(uint32_t index) const;
+
     /// The output at the specified index within this transaction.
     chain::output output(uint32_t index) const;
 
+    /// The wire serialized size of the transaction (read from slab).
+    size_t serialized_size() const;
+
+    /// The size of the stored transaction, excluding metadata.
+    size_t stored_size() const;
+
+    /// Stream the wire serialization directly from the slab.
+    void to_data(writer& sink) const;
+
     /// The transaction.
     chain::transaction transaction() const;
 
 private:
+    uint8_t* find_output(uint32_t index) const;
+
     memory_ptr slab_;
     const uint32_t height_;
     const uint32_t median_time_past_;
     const uint16_t position_;
+    const bool compressed_;
     const hash_digest hash_;
 };
 
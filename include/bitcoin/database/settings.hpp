@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <boost/filesystem.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/unspent_outputs.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -40,9 +41,16 @@ public:
     uint32_t index_start_height;
     uint32_t block_table_buckets;
     uint32_t transaction_table_buckets;
+    uint32_t transaction_pool_table_buckets;
+    uint32_t unspent_table_buckets;
     uint32_t spend_table_buckets;
     uint32_t history_table_buckets;
-    uint32_t cache_capacity;
+    uint32_t cache_bytes;
+    eviction_policy cache_policy;
+    uint32_t cache_warm_blocks;
+    bool cache_headers;
+    uint32_t block_cache_capacity;
+    bool compress_outputs;
 };
 
 } // namespace database
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DATABASE_SHORT_IDS_HPP
+#define LIBBITCOIN_DATABASE_SHORT_IDS_HPP
+
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Compact block (bip152) short ids, as 48 bit values.
+typedef std::vector<uint64_t> short_id_list;
+
+/// Tag for a tx index slot holding a short id in place of a tx offset.
+static BC_CONSTEXPR uint64_t short_id_tag = uint64_t(1) << 63;
+
+/// The siphash key for short ids of the compact block.
+BCD_API siphash_key short_id_key(const message::compact_block& compact);
+
+/// The short id of the transaction hash under the key.
+BCD_API uint64_t to_short_id(const siphash_key& key, const hash_digest& hash);
+
+/// The short id value of the wire encoded short id.
+BCD_API uint64_t to_short_id(const message::compact_block::short_id& id);
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -87,6 +87,15 @@ public:
     const path block_table;
     const path transaction_table;
     const path transaction_index;
+    const path transaction_pool_index;
+    const path transaction_pool_table;
+    const path unspent_table;
+
+    /// Transaction table output encoding (written at create, checked at open).
+    const path transaction_format;
+
+    /// Output cache snapshot (optional, not created).
+    const path output_cache;
 
     /// Optional indexes.
     const path history_rows;
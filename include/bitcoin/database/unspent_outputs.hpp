@@ -19,46 +19,88 @@
 #ifndef LIBBITCOIN_DATABASE_UNSPENT_OUTPUTS_HPP
 #define LIBBITCOIN_DATABASE_UNSPENT_OUTPUTS_HPP
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <boost/bimap.hpp>
-#include <boost/bimap/set_of.hpp>
-#include <boost/bimap/unordered_set_of.hpp>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/define.hpp>
-#include <bitcoin/database/unspent_transaction.hpp>
 
 namespace libbitcoin {
 namespace database {
 
+/// The replacement policy of the unspent output cache.
+enum class eviction_policy
+{
+    /// Evict the oldest output.
+    fifo,
+
+    /// Evict the oldest output not read since it was last considered (CLOCK).
+    clock,
+
+    /// As clock, but coinbase outputs (immature for 100 blocks) are not
+    /// cached, leaving the space to quickly-spent change and payments.
+    selective
+};
+
+/// The name of the policy, for reporting.
+BCD_API std::string to_string(eviction_policy policy);
+
 /// This class is thread safe.
-/// A circular-by-age hash table of [point, output].
+/// A circular-by-age hash table of [point, output], sharded by tx hash so
+/// that concurrent readers and writers of unrelated txs do not contend.
+/// Outputs are held in flat per-shard pools, indexed by an open-addressed
+/// table of pool slots, and capacity is in bytes.
 class BCD_API unspent_outputs
   : noncopyable
 {
 public:
-    // Construct a cache with the specified transaction count limit.
-    unspent_outputs(size_t capacity);
+    /// The maximum number of shards.
+    static const size_t maximum_shards;
+
+    /// The minimum number of bytes per shard.
+    static const size_t minimum_shard_capacity;
+
+    /// The bytes charged for each output (excluding an oversized script).
+    static const size_t output_overhead;
+
+    /// Scripts up to this size are held inline, larger are charged in full.
+    static const size_t inline_script_size;
+
+    // Construct a cache with the specified byte limit.
+    unspent_outputs(size_t capacity,
+        eviction_policy policy=eviction_policy::fifo);
 
     /// The cache capacity is zero.
     bool disabled() const;
 
+    /// The replacement policy.
+    eviction_policy policy() const;
+
     /// The cache has no elements.
     size_t empty() const;
 
-    /// The number of elements in the cache.
+    /// The number of outputs in the cache.
     size_t size() const;
 
+    /// The number of bytes charged against the capacity.
+    size_t usage() const;
+
+    /// The number of independently-locked shards.
+    size_t shards() const;
+
     /// The cache performance as a ratio of hits to accesses.
     float hit_rate() const;
 
-    /// Add a set of outputs to the cache (purges older entry).
+    /// Add a set of outputs to the cache (purges older entries).
     void add(const chain::transaction& transaction, size_t height,
         uint32_t median_time_past, bool confirmed);
 
     /// Remove a set of outputs from the cache (has been reorganized out).
-    void remove(const hash_digest& tx_hash);
+    void remove(const chain::transaction& transaction);
 
     /// Remove an output from the cache (has been spent).
     void remove(const chain::output_point& point);
@@ -69,22 +111,82 @@ public:
         const chain::output_point& point, size_t fork_height,
         bool require_confirmed) const;
 
-private:
-    // A bidirection map is used for efficient output and position retrieval.
-    // This produces the effect of a circular buffer tx hash table of outputs.
-    typedef boost::bimaps::bimap<
-        boost::bimaps::unordered_set_of<unspent_transaction>,
-        boost::bimaps::set_of<uint32_t>> unspent_transactions;
+    /// Write the outputs (oldest first) to a snapshot file tagged by hash.
+    bool save(const boost::filesystem::path& file,
+        const hash_digest& tag) const;
 
-    // These are thread safe.
-    const size_t capacity_;
-    mutable std::atomic<size_t> hits_;
-    mutable std::atomic<size_t> queries_;
+    /// Add the outputs of a snapshot file, if it is tagged by the hash.
+    bool load(const boost::filesystem::path& file, const hash_digest& tag);
 
-    // These are protected by mutex.
-    uint32_t sequence_;
-    unspent_transactions unspent_;
-    mutable upgrade_mutex mutex_;
+private:
+    typedef uint32_t slot;
+
+    // Holds the common standard scripts (p2pkh, p2sh, p2wpkh, p2wsh).
+    static BC_CONSTEXPR size_t script_capacity = 34;
+
+    // A pooled output, linked by age within its shard.
+    struct entry
+    {
+        chain::point point;
+        uint64_t value;
+        uint32_t height;
+        uint32_t median_time_past;
+        slot older;
+        slot newer;
+        bool coinbase;
+        bool confirmed;
+        uint8_t script_size;
+        std::array<uint8_t, script_capacity> script;
+        data_chunk oversized_script;
+    };
+
+    // Each shard is an independent circular buffer with its own statistics.
+    struct shard
+    {
+        shard();
+
+        // These are thread safe.
+        size_t capacity;
+        mutable std::atomic<size_t> hits;
+        mutable std::atomic<size_t> queries;
+
+        // These are protected by mutex.
+        size_t usage;
+        slot oldest;
+        slot newest;
+        std::vector<entry> pool;
+        std::vector<slot> free;
+        std::vector<slot> table;
+
+        // Set when read, cleared by eviction (not used by fifo).
+        std::vector<std::atomic<bool>> referenced;
+        mutable upgrade_mutex mutex;
+    };
+
+    static size_t shard_count(size_t capacity);
+    static size_t table_size(size_t outputs);
+    static size_t footprint(const entry& entry);
+    static void set_script(entry& entry, data_chunk&& script);
+    static data_chunk get_script(const entry& entry);
+    shard& get_shard(const hash_digest& tx_hash) const;
+
+    // This is not thread safe and requires a shared shard lock.
+    static size_t bucket(const shard& shard, const chain::point& point);
+    static slot find(const shard& shard, const chain::point& point);
+
+    // These are not thread safe and require an exclusive shard lock.
+    static void index(shard& shard, slot position);
+    static void deindex(shard& shard, slot position);
+    static void link(shard& shard, slot position);
+    static void unlink(shard& shard, slot position);
+    static void erase(shard& shard, slot position);
+    void evict(shard& shard);
+    void insert(shard& shard, entry&& entry);
+
+    // The capacity is divided among the shards.
+    const size_t capacity_;
+    const eviction_policy policy_;
+    mutable std::vector<shard> shards_;
 };
 
 } // namespace database
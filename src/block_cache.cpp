@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/block_cache.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+block_cache::block_cache(size_t capacity)
+  : capacity_(capacity), usage_(0)
+{
+}
+
+bool block_cache::disabled() const
+{
+    return capacity_ == 0;
+}
+
+size_t block_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return positions_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t block_cache::usage() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return usage_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_cache::add(const hash_digest& hash, data_chunk&& data)
+{
+    const auto size = data.size();
+
+    if (size == 0 || size > capacity_)
+        return;
+
+    const auto value = std::make_shared<const data_chunk>(std::move(data));
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = positions_.find(hash);
+
+    if (it != positions_.end())
+        erase(it->second);
+
+    while (usage_ + size > capacity_)
+        erase(std::prev(queue_.end()));
+
+    queue_.push_front({ hash, value });
+    positions_.emplace(hash, queue_.begin());
+    usage_ += size;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_cache::remove(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = positions_.find(hash);
+
+    if (it != positions_.end())
+        erase(it->second);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+block_cache::data_ptr block_cache::get(const hash_digest& hash) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = positions_.find(hash);
+
+    if (it == positions_.end())
+        return nullptr;
+
+    // Move the entry to the front, as the most recently used.
+    queue_.splice(queue_.begin(), queue_, it->second);
+    return it->second->data;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void block_cache::erase(queue::iterator position)
+{
+    usage_ -= position->data->size();
+    positions_.erase(position->hash);
+    queue_.erase(position);
+}
+
+} // namespace database
+} // namespace libbitcoin
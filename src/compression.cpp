@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/compression.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+// Script code (varint) followed by payload:
+// ----------------------------------------------------------------------------
+// [ 0 ] pay key hash            [ hash:20 ]
+// [ 1 ] pay script hash         [ hash:20 ]
+// [ 2 ] pay witness key hash    [ hash:20 ]
+// [ 3 ] pay witness script hash [ hash:32 ]
+// [ n ] other (size = n - 4)    [ script:size ]
+
+enum script_code : uint64_t
+{
+    pay_key_hash = 0,
+    pay_script_hash = 1,
+    pay_witness_key_hash = 2,
+    pay_witness_script_hash = 3,
+    templates = 4
+};
+
+static constexpr auto short_size = short_hash_size;
+static constexpr auto long_size = hash_size;
+
+// [dup hash160 [20] equalverify checksig]
+static constexpr size_t pay_key_hash_size = 3 + short_size + 2;
+
+// [hash160 [20] equal]
+static constexpr size_t pay_script_hash_size = 2 + short_size + 1;
+
+// [0 [20]]
+static constexpr size_t pay_witness_key_hash_size = 2 + short_size;
+
+// [0 [32]]
+static constexpr size_t pay_witness_script_hash_size = 2 + long_size;
+
+static constexpr uint8_t op_0 = 0x00;
+static constexpr uint8_t op_push_20 = 0x14;
+static constexpr uint8_t op_push_32 = 0x20;
+static constexpr uint8_t op_dup = 0x76;
+static constexpr uint8_t op_equal = 0x87;
+static constexpr uint8_t op_equalverify = 0x88;
+static constexpr uint8_t op_hash160 = 0xa9;
+static constexpr uint8_t op_checksig = 0xac;
+
+// Amounts.
+// ----------------------------------------------------------------------------
+
+// Factor out up to nine decimal zeros, retaining the last nonzero digit.
+// The code of a value above max_money could overflow, so it is escaped.
+uint64_t compress_amount(uint64_t value)
+{
+    if (value > max_money())
+        return amount_escape;
+
+    if (value == 0)
+        return 0;
+
+    uint64_t exponent = 0;
+
+    for (; (value % 10) == 0 && exponent < 9; ++exponent)
+        value /= 10;
+
+    if (exponent < 9)
+    {
+        const auto digit = value % 10;
+        value /= 10;
+        return 1 + (value * 9 + digit - 1) * 10 + exponent;
+    }
+
+    return 1 + (value - 1) * 10 + 9;
+}
+
+uint64_t decompress_amount(uint64_t value)
+{
+    if (value == 0)
+        return 0;
+
+    --value;
+    auto exponent = value % 10;
+    value /= 10;
+    uint64_t amount;
+
+    if (exponent < 9)
+    {
+        const auto digit = (value % 9) + 1;
+        value /= 9;
+        amount = value * 10 + digit;
+    }
+    else
+    {
+        amount = value + 1;
+    }
+
+    for (; exponent > 0; --exponent)
+        amount *= 10;
+
+    return amount;
+}
+
+size_t compressed_amount_size(uint64_t value)
+{
+    const auto code = compress_amount(value);
+    const auto size = variable_uint_size(code);
+    return code == amount_escape ? size + sizeof(uint64_t) : size;
+}
+
+void compress_amount(writer& sink, uint64_t value)
+{
+    const auto code = compress_amount(value);
+    sink.write_variable_little_endian(code);
+
+    if (code == amount_escape)
+        sink.write_8_bytes_little_endian(value);
+}
+
+uint64_t decompress_amount(reader& source)
+{
+    const auto code = source.read_variable_little_endian();
+
+    return code == amount_escape ? source.read_8_bytes_little_endian() :
+        decompress_amount(code);
+}
+
+// Scripts.
+// ----------------------------------------------------------------------------
+
+// Returns the template code of the script or templates if nonstandard.
+static uint64_t to_code(const data_chunk& script)
+{
+    const auto size = script.size();
+
+    if (size == pay_key_hash_size && script[0] == op_dup &&
+        script[1] == op_hash160 && script[2] == op_push_20 &&
+        script[23] == op_equalverify && script[24] == op_checksig)
+        return script_code::pay_key_hash;
+
+    if (size == pay_script_hash_size && script[0] == op_hash160 &&
+        script[1] == op_push_20 && script[22] == op_equal)
+        return script_code::pay_script_hash;
+
+    if (size == pay_witness_key_hash_size && script[0] == op_0 &&
+        script[1] == op_push_20)
+        return script_code::pay_witness_key_hash;
+
+    if (size == pay_witness_script_hash_size && script[0] == op_0 &&
+        script[1] == op_push_32)
+        return script_code::pay_witness_script_hash;
+
+    return script_code::templates;
+}
+
+// The offset of the template hash within the script.
+static size_t hash_offset(uint64_t code)
+{
+    return code == script_code::pay_key_hash ? 3 : 2;
+}
+
+size_t compressed_script_size(const chain::script& script)
+{
+    const auto data = script.to_data(false);
+    const auto code = to_code(data);
+
+    if (code != script_code::templates)
+        return variable_uint_size(code) + script_payload_size(code);
+
+    const auto size = data.size();
+    return variable_uint_size(size + script_code::templates) + size;
+}
+
+void compress_script(writer& sink, const chain::script& script)
+{
+    const auto data = script.to_data(false);
+    const auto code = to_code(data);
+
+    if (code != script_code::templates)
+    {
+        sink.write_variable_little_endian(code);
+        sink.write_bytes(&data[hash_offset(code)], script_payload_size(code));
+        return;
+    }
+
+    sink.write_variable_little_endian(data.size() + script_code::templates);
+    sink.write_bytes(data);
+}
+
+size_t script_payload_size(uint64_t code)
+{
+    switch (code)
+    {
+        case script_code::pay_key_hash:
+        case script_code::pay_script_hash:
+        case script_code::pay_witness_key_hash:
+            return short_size;
+        case script_code::pay_witness_script_hash:
+            return long_size;
+        default:
+            return static_cast<size_t>(code - script_code::templates);
+    }
+}
+
+size_t script_size(uint64_t code)
+{
+    switch (code)
+    {
+        case script_code::pay_key_hash:
+            return pay_key_hash_size;
+        case script_code::pay_script_hash:
+            return pay_script_hash_size;
+        case script_code::pay_witness_key_hash:
+            return pay_witness_key_hash_size;
+        case script_code::pay_witness_script_hash:
+            return pay_witness_script_hash_size;
+        default:
+            return static_cast<size_t>(code - script_code::templates);
+    }
+}
+
+void decompress_script(writer& sink, uint64_t code, const uint8_t* payload)
+{
+    const auto size = script_payload_size(code);
+
+    switch (code)
+    {
+        case script_code::pay_key_hash:
+            sink.write_byte(op_dup);
+            sink.write_byte(op_hash160);
+            sink.write_byte(op_push_20);
+            sink.write_bytes(payload, size);
+            sink.write_byte(op_equalverify);
+            sink.write_byte(op_checksig);
+            return;
+        case script_code::pay_script_hash:
+            sink.write_byte(op_hash160);
+            sink.write_byte(op_push_20);
+            sink.write_bytes(payload, size);
+            sink.write_byte(op_equal);
+            return;
+        case script_code::pay_witness_key_hash:
+            sink.write_byte(op_0);
+            sink.write_byte(op_push_20);
+            sink.write_bytes(payload, size);
+            return;
+        case script_code::pay_witness_script_hash:
+            sink.write_byte(op_0);
+            sink.write_byte(op_push_32);
+            sink.write_bytes(payload, size);
+            return;
+        default:
+            sink.write_bytes(payload, size);
+            return;
+    }
+}
+
+data_chunk decompress_script(uint64_t code, const uint8_t* payload)
+{
+    data_chunk data(script_size(code));
+    auto serial = make_unsafe_serializer(data.begin());
+    decompress_script(serial, code, payload);
+    return data;
+}
+
+} // namespace database
+} // namespace libbitcoin
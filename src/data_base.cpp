@@ -50,7 +50,9 @@ using namespace bc::wallet;
 data_base::data_base(const settings& settings)
   : closed_(true),
     settings_(settings),
+    unspent_height_(0),
     remap_mutex_(std::make_shared<shared_mutex>()),
+    block_cache_(settings.block_cache_capacity),
     store(settings.directory, settings.index_start_height < without_indexes,
         settings.flush_writes)
 {
@@ -58,6 +60,8 @@ data_base::data_base(const settings& settings)
         << "Buckets: "
         << "block [" << settings.block_table_buckets << "], "
         << "transaction [" << settings.transaction_table_buckets << "], "
+        << "pool [" << settings.transaction_pool_table_buckets << "], "
+        << "unspent [" << settings.unspent_table_buckets << "], "
         << "spend [" << settings.spend_table_buckets << "], "
         << "history [" << settings.history_table_buckets << "]";
 }
@@ -67,6 +71,47 @@ data_base::~data_base()
     close();
 }
 
+// The unspent table reflects all blocks below the first gap.
+static size_t get_unspent_height(const block_database& blocks)
+{
+    size_t top;
+    const auto missing = blocks.missing();
+
+    if (!missing.empty())
+        return missing.front().first;
+
+    return blocks.top(top) ? top + 1 : 0;
+}
+
+// The transaction table output encoding cannot change after create.
+static constexpr char uncompressed_format = 'x';
+static constexpr char compressed_format = 'c';
+
+static bool write_format(const boost::filesystem::path& file, bool compressed)
+{
+    bc::ofstream stream(file.string(), std::ios::binary);
+
+    if (!stream.good())
+        return false;
+
+    stream.put(compressed ? compressed_format : uncompressed_format);
+    stream.flush();
+    return stream.good();
+}
+
+// A store without the format file predates compression (uncompressed).
+static bool is_format(const boost::filesystem::path& file, bool compressed)
+{
+    if (!boost::filesystem::exists(file))
+        return !compressed;
+
+    bc::ifstream stream(file.string(), std::ios::binary);
+    const auto format = stream.get();
+
+    return stream.good() &&
+        format == (compressed ? compressed_format : uncompressed_format);
+}
+
 // Open and close.
 // ----------------------------------------------------------------------------
 
@@ -79,7 +124,8 @@ bool data_base::create(const block& genesis)
         return false;
 
     // Create files.
-    if (!store::create())
+    if (!store::create() ||
+        !write_format(transaction_format, settings_.compress_outputs))
         return false;
 
     start();
@@ -87,7 +133,8 @@ bool data_base::create(const block& genesis)
     // These leave the databases open.
     auto created =
         blocks_->create() &&
-        transactions_->create();
+        transactions_->create() &&
+        unspents_->create();
 
     if (use_indexes)
         created = created &&
@@ -99,6 +146,7 @@ bool data_base::create(const block& genesis)
         return false;
 
     // Store the first block.
+    unspent_height_ = 0;
     push(genesis, 0);
     closed_ = false;
     return true;
@@ -113,11 +161,20 @@ bool data_base::open()
     if (!store::open())
         return false;
 
+    if (!is_format(transaction_format, settings_.compress_outputs))
+    {
+        LOG_ERROR(LOG_DATABASE)
+            << "The compress_outputs setting does not match the store.";
+        store::close();
+        return false;
+    }
+
     start();
 
     auto opened =
         blocks_->open() &&
-        transactions_->open();
+        transactions_->open() &&
+        unspents_->open();
 
     if (use_indexes)
         opened = opened &&
@@ -125,6 +182,24 @@ bool data_base::open()
             history_->open() &&
             stealth_->open();
 
+    // Pool compaction rewrites the pool table in place, so is guarded by the
+    // flush lock (a crash within it is detected at the next open).
+    if (opened && begin_write())
+    {
+        const auto compacted = transactions_->compact_pool();
+        opened = end_write() && compacted;
+    }
+    else
+    {
+        opened = false;
+    }
+
+    if (opened)
+    {
+        unspent_height_ = get_unspent_height(*blocks_);
+        load_cache();
+    }
+
     closed_ = false;
     return opened;
 }
@@ -137,10 +212,12 @@ bool data_base::close()
         return true;
 
     closed_ = true;
+    save_cache();
 
     auto closed =
         blocks_->close() &&
-        transactions_->close();
+        transactions_->close() &&
+        unspents_->close();
 
     if (use_indexes)
         closed = closed &&
@@ -158,11 +235,18 @@ void data_base::start()
 {
     blocks_ = std::make_shared<block_database>(block_table, block_index,
         transaction_index, settings_.block_table_buckets,
-        settings_.file_growth_rate, remap_mutex_);
+        settings_.file_growth_rate, settings_.cache_headers, remap_mutex_);
 
     transactions_ = std::make_shared<transaction_database>(transaction_table,
-        settings_.transaction_table_buckets, settings_.file_growth_rate,
-        settings_.cache_capacity, remap_mutex_);
+        transaction_pool_table, transaction_pool_index,
+        settings_.transaction_table_buckets,
+        settings_.transaction_pool_table_buckets, settings_.file_growth_rate,
+        settings_.cache_bytes, settings_.cache_policy,
+        settings_.compress_outputs, remap_mutex_);
+
+    unspents_ = std::make_shared<unspent_database>(unspent_table,
+        settings_.unspent_table_buckets, settings_.file_growth_rate,
+        remap_mutex_);
 
     if (use_indexes)
     {
@@ -179,6 +263,57 @@ void data_base::start()
     }
 }
 
+// Restore the output cache from snapshot, otherwise warm it from top blocks.
+void data_base::load_cache()
+{
+    size_t top;
+
+    if (settings_.cache_bytes == 0 || !blocks_->top(top))
+        return;
+
+    if (transactions_->load_cache(output_cache, blocks_->get(top).hash()))
+    {
+        LOG_INFO(LOG_DATABASE)
+            << "Loaded output cache snapshot at height: " << top;
+        return;
+    }
+
+    const auto count = std::min(size_t(settings_.cache_warm_blocks), top + 1);
+
+    for (auto height = top + 1 - count; height <= top; ++height)
+    {
+        const auto result = blocks_->get(height);
+
+        if (result)
+            transactions_->warm_cache(result);
+    }
+
+    if (count != 0)
+        LOG_INFO(LOG_DATABASE)
+            << "Warmed output cache from blocks: " << count;
+}
+
+// Snapshot the output cache, tagged by the top block hash.
+void data_base::save_cache()
+{
+    size_t top;
+
+    if (settings_.cache_bytes == 0 || !blocks_->top(top))
+        return;
+
+    if (!transactions_->save_cache(output_cache, blocks_->get(top).hash()))
+        LOG_ERROR(LOG_DATABASE)
+            << "Failed to write output cache snapshot.";
+}
+
+// Serialization is paid once at push (shared with the stored checksum), in
+// place of each serving of the block.
+void data_base::cache_block(const hash_digest& hash, data_chunk&& data)
+{
+    if (!block_cache_.disabled())
+        block_cache_.add(hash, std::move(data));
+}
+
 // protected
 bool data_base::flush() const
 {
@@ -191,7 +326,8 @@ bool data_base::flush() const
 
     auto flushed =
         blocks_->flush() &&
-        transactions_->flush();
+        transactions_->flush() &&
+        unspents_->flush();
 
     if (use_indexes)
         flushed = flushed &&
@@ -216,6 +352,7 @@ void data_base::synchronize()
         stealth_->synchronize();
     }
 
+    unspents_->synchronize();
     transactions_->synchronize();
     blocks_->synchronize();
 }
@@ -233,6 +370,11 @@ const transaction_database& data_base::transactions() const
     return *transactions_;
 }
 
+const unspent_database& data_base::unspents() const
+{
+    return *unspents_;
+}
+
 // Invalid if indexes not initialized.
 const spend_database& data_base::spends() const
 {
@@ -251,6 +393,30 @@ const stealth_database& data_base::stealth() const
     return *stealth_;
 }
 
+bool data_base::get_block_data(data_chunk& out_data,
+    const hash_digest& hash) const
+{
+    const auto cached = block_cache_.get(hash);
+
+    if (cached)
+    {
+        out_data.assign(cached->begin(), cached->end());
+        return true;
+    }
+
+    const auto result = blocks_->get(hash, true);
+
+    if (!result)
+        return false;
+
+    out_data.clear();
+    data_sink ostream(out_data);
+    ostream_writer sink(ostream);
+    const auto streamed = transactions_->get_block_data(sink, result);
+    ostream.flush();
+    return streamed;
+}
+
 // Synchronous writers.
 // ----------------------------------------------------------------------------
 
@@ -295,12 +461,68 @@ code data_base::verify_push(const block& block, size_t height)
     return error::success;
 }
 
+// This store-level check is a failsafe for blockchain behavior.
+code data_base::verify_push(const header::list& headers, size_t first_height)
+{
+    if (headers.empty())
+        return error::success;
+
+    for (size_t index = 1; index < headers.size(); ++index)
+        if (headers[index].previous_block_hash() != headers[index - 1].hash())
+            return error::store_block_missing_parent;
+
+    const auto next_height = get_next_height(blocks());
+
+    // Confirmed heights cannot be overwritten.
+    if (first_height < next_height)
+        return error::store_block_invalid_height;
+
+    const auto& parent = headers.front().previous_block_hash();
+
+    // The headers extend the confirmed top.
+    if (first_height == next_height)
+        return parent == get_previous_hash(blocks(), first_height) ?
+            error::success : error::store_block_missing_parent;
+
+    // The headers extend a run of headers stored above the confirmed top.
+    const auto result = blocks_->get(parent, false);
+
+    if (!result)
+        return error::store_block_missing_parent;
+
+    return result.height() + 1 == first_height ? error::success :
+        error::store_block_invalid_height;
+}
+
 // This store-level check is a failsafe for blockchain behavior.
 code data_base::verify_push(const transaction& tx)
 {
-    const auto result = transactions_->get(tx.hash(), max_size_t, false);
-    return result && !result.is_spent(max_size_t) ? error::unspent_duplicate :
-        error::success;
+    const auto tx_hash = tx.hash();
+    const auto result = transactions_->get(tx_hash, max_size_t, false);
+
+    if (!result)
+        return error::success;
+
+    // An unconfirmed duplicate cannot be spent.
+    if (!result.confirmed())
+        return error::unspent_duplicate;
+
+    bool coinbase;
+    size_t height;
+    uint32_t median_time_past;
+    chain::output output;
+    const auto outputs = tx.outputs().size();
+
+    // Any output in the unspent table proves the duplicate is unspent.
+    for (uint32_t index = 0; index < outputs; ++index)
+        if (unspents_->get(output, height, median_time_past, coinbase,
+            { tx_hash, index }))
+            return error::unspent_duplicate;
+
+    // A miss is not proof of spend, as unspendable outputs are never stored
+    // and blocks above a gap are not yet applied, so defer to the tx table.
+    return result.is_spent(max_size_t) ? error::success :
+        error::unspent_duplicate;
 }
 
 bool data_base::begin_insert() const
@@ -336,8 +558,12 @@ code data_base::insert(const chain::block& block, size_t height)
         !push_heights(block, height))
         return error::operation_failed;
 
-    blocks_->store(block, height, true);
+    // Serialize once, for both the stored checksum and the block cache.
+    auto data = block.to_data(true);
+    blocks_->store(block, height, block_database::checksum(data), true);
+    push_unspents(block, height);
     synchronize();
+    cache_block(block.hash(), std::move(data));
     return error::success;
 }
 
@@ -393,8 +619,39 @@ code data_base::push(const block& block, size_t height)
         !push_heights(block, height))
         return error::operation_failed;
 
-    blocks_->store(block, height, true);
+    // Serialize once, for both the stored checksum and the block cache.
+    auto data = block.to_data(true);
+    blocks_->store(block, height, block_database::checksum(data), true);
+    push_unspents(block, height);
     synchronize();
+    cache_block(block.hash(), std::move(data));
+
+    return end_write() ? error::success : error::operation_failed;
+    // End Flush Lock
+    //^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Headers-first sync writes headers in bulk, without transactions or indexing.
+// This is designed for write exclusivity and read concurrency.
+code data_base::push(const header::list& headers, size_t first_height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(write_mutex_);
+
+    const auto ec = verify_push(headers, first_height);
+
+    if (ec)
+        return ec;
+
+    // Begin Flush Lock
+    //vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv
+    if (!begin_write())
+        return error::operation_failed;
+
+    blocks_->store(headers, first_height, false);
+    blocks_->synchronize();
 
     return end_write() ? error::success : error::operation_failed;
     // End Flush Lock
@@ -423,7 +680,7 @@ bool data_base::push_transactions(const chain::block& block, size_t height,
         const auto tx_hash = tx.hash();
 
         if (position != 0)
-            push_inputs(tx_hash, height, tx.inputs());
+            push_inputs(tx_hash, height, tx.inputs(), txs);
 
         push_outputs(tx_hash, height, tx.outputs());
         push_stealth(tx_hash, height, tx.outputs());
@@ -439,15 +696,115 @@ bool data_base::push_heights(const chain::block& block, size_t height)
 
     // Skip coinbase as it has no previous output.
     for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
+    {
         for (const auto& input: tx->inputs())
-            if (!transactions_->spend(input.previous_output(), height))
+        {
+            const auto& prevout = input.previous_output();
+
+            if (!transactions_->spend(prevout, height))
                 return false;
+        }
+    }
 
     return true;
 }
 
+// The unspent table reflects the contiguous chain from genesis. Blocks are
+// applied in height order, so a block inserted above a gap is deferred and
+// read back from the store once the gap is filled. This also serializes the
+// unspent table writes of concurrent inserts.
+void data_base::push_unspents(const block& block, size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(unspent_mutex_);
+
+    if (height == unspent_height_)
+    {
+        push_unspents(block.transactions(), height,
+            block.header().validation.median_time_past);
+        ++unspent_height_;
+    }
+
+    transaction::list transactions;
+
+    // Apply deferred blocks that are now contiguous.
+    while (blocks_->exists(unspent_height_))
+    {
+        auto result = blocks_->get(unspent_height_);
+
+        if (!result)
+            break;
+
+        transactions.clear();
+        transactions.reserve(result.transaction_count());
+
+        for (const auto offset: result.transaction_offsets())
+            transactions.push_back(transactions_->get(offset).transaction());
+
+        const auto median_time_past = result.median_time_past();
+
+        // Release the block record before writing.
+        result.reset();
+        push_unspents(transactions, unspent_height_, median_time_past);
+        ++unspent_height_;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void data_base::push_unspents(const transaction::list& transactions,
+    size_t height, uint32_t median_time_past)
+{
+    if (transactions.empty())
+        return;
+
+    for (const auto& tx: transactions)
+        unspents_->store(tx, height, median_time_past);
+
+    // Skip coinbase as it has no previous output.
+    for (auto tx = transactions.begin() + 1; tx != transactions.end(); ++tx)
+        for (const auto& input: tx->inputs())
+            /* bool */ unspents_->unlink(input.previous_output());
+}
+
+// Push and pop must agree on the spent value of an input history row, which
+// accumulates into the address summary. Both read the previous output from
+// the store. The validation cache is a copy of the same output, and an output
+// of the same block may not yet be stored (parallel push), so is read there.
+uint64_t data_base::get_spent(const output_point& prevout, size_t height,
+    const transaction::list& block_txs) const
+{
+    if (prevout.validation.cache.is_valid())
+        return prevout.validation.cache.value();
+
+    const auto value = get_spent(prevout, height);
+
+    if (value != 0)
+        return value;
+
+    for (const auto& tx: block_txs)
+        if (tx.hash() == prevout.hash())
+            return prevout.index() < tx.outputs().size() ?
+                tx.outputs()[prevout.index()].value() : 0;
+
+    return 0;
+}
+
+uint64_t data_base::get_spent(const output_point& prevout,
+    size_t height) const
+{
+    bool coinbase;
+    size_t prevout_height;
+    uint32_t median_time_past;
+    chain::output output;
+
+    return transactions_->get_output(output, prevout_height,
+        median_time_past, coinbase, prevout, height, true) ?
+            output.value() : 0;
+}
+
 void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
-    const input::list& inputs)
+    const input::list& inputs, const transaction::list& block_txs)
 {
     for (uint32_t index = 0; index < inputs.size(); ++index)
     {
@@ -457,13 +814,15 @@ void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
         const auto checksum = prevout.checksum();
 
         spends_->store(prevout, inpoint);
+        const auto spent = get_spent(prevout, height, block_txs);
 
         if (prevout.validation.cache.is_valid())
         {
             // This results in a complete and unambiguous history for the
             // address since standard outputs contain unambiguous address data.
             for (const auto& address: prevout.validation.cache.addresses())
-                history_->store(address.hash(), { height, inpoint, checksum });
+                history_->store(address.hash(), { height, inpoint, checksum },
+                    spent);
         }
         else
         {
@@ -472,7 +831,8 @@ void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
             // which significantly expands the size of the history store.
             // These are tradeoffs when no prevout is cached (checkpoint sync).
             for (const auto& address: input.addresses())
-                history_->store(address.hash(), { height, inpoint, checksum });
+                history_->store(address.hash(), { height, inpoint, checksum },
+                    spent);
         }
     }
 }
@@ -542,17 +902,42 @@ bool data_base::pop(block& out_block)
     if (!blocks_->top(height))
         return false;
 
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(unspent_mutex_);
+
+    if (!pop_transactions(out_block, height) || !blocks_->unconfirm(height))
+        return false;
+
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    block_cache_.remove(out_block.hash());
+
+    // Synchronise everything that was changed.
+    synchronize();
+
+    // Return the block (with header/block metadata and pop start time).
+    out_block.validation.error = error::success;
+    out_block.validation.start_pop = start_time;
+    return true;
+}
+
+// Demote the block's txs and their indexes, leaving the block confirmed.
+// The caller must hold unspent_mutex_ and unconfirm the block afterward.
+// A false return implies store corruption.
+bool data_base::pop_transactions(block& out_block, size_t height)
+{
     // This should never become invalid if this call is protected.
-    const auto block = blocks_->get(height);
-    if (!block)
+    auto result = blocks_->get(height);
+    if (!result)
         return false;
 
     transaction::list transactions;
-    transactions.reserve(block.transaction_count());
-    const auto offsets = block.transaction_offsets();
+    transactions.reserve(result.transaction_count());
     size_t position = 0;
 
-    for (const auto offset: block.transaction_offsets())
+    for (const auto offset: result.transaction_offsets())
     {
         const auto tx = transactions_->get(offset);
 
@@ -563,6 +948,14 @@ bool data_base::pop(block& out_block)
         transactions.push_back(tx.transaction());
     }
 
+    auto header = result.header();
+
+    // Release the block record before writing.
+    result.reset();
+
+    // A block above a gap has not been applied to the unspent table.
+    const auto unspent = height < unspent_height_;
+
     // Loop txs backwards, the reverse of how they were added.
     // Remove txs, then outputs, then inputs (also reverse order).
     for (auto tx = transactions.rbegin(); tx != transactions.rend(); ++tx)
@@ -570,6 +963,9 @@ bool data_base::pop(block& out_block)
         if (!transactions_->unconfirm(tx->hash()))
             return false;
 
+        if (unspent && !pop_unspents(*tx, height))
+            return false;
+
         if (!pop_outputs(tx->outputs(), height))
             return false;
 
@@ -577,16 +973,10 @@ bool data_base::pop(block& out_block)
             return false;
     }
 
-    if (!blocks_->unconfirm(height))
-        return false;
-
-    // Synchronise everything that was changed.
-    synchronize();
+    if (unspent)
+        unspent_height_ = height;
 
-    // Return the block (with header/block metadata and pop start time).
-    out_block = chain::block(block.header(), std::move(transactions));
-    out_block.validation.error = error::success;
-    out_block.validation.start_pop = start_time;
+    out_block = chain::block(std::move(header), std::move(transactions));
     return true;
 }
 
@@ -604,9 +994,46 @@ bool data_base::pop_inputs(const input::list& inputs, size_t height)
         // This can fail if index start has been changed between restarts.
         /* bool */ spends_->unlink(input->previous_output());
 
+        // The spent value is deducted from the address summary.
+        const auto spent = get_spent(input->previous_output(), height);
+
         // Delete can fail if index start has been changed between restarts.
         for (const auto& address: input->addresses())
-            /* bool */ history_->unlink_last_row(address.hash());
+            /* bool */ history_->unlink_last_row(address.hash(), spent);
+    }
+
+    return true;
+}
+
+// A false return implies store corruption.
+bool data_base::pop_unspents(const transaction& tx, size_t height)
+{
+    const auto tx_hash = tx.hash();
+    const auto outputs = tx.outputs().size();
+
+    // Unspendable and spent outputs are not present, so ignore failure.
+    for (uint32_t index = 0; index < outputs; ++index)
+        /* bool */ unspents_->unlink({ tx_hash, index });
+
+    if (tx.is_coinbase())
+        return true;
+
+    bool coinbase;
+    size_t prevout_height;
+    uint32_t median_time_past;
+    chain::output prevout;
+
+    // Restore the previous outputs, which remain confirmed below the tx.
+    for (const auto& input: tx.inputs())
+    {
+        const auto& point = input.previous_output();
+
+        if (!transactions_->get_output(prevout, prevout_height,
+            median_time_past, coinbase, point, height, true))
+            return false;
+
+        unspents_->store(point, prevout, prevout_height, median_time_past,
+            coinbase);
     }
 
     return true;
@@ -724,11 +1151,14 @@ void data_base::handle_push_transactions(const code& ec, block_const_ptr block,
         return;
     }
 
-    // Store the block as confirmed.
-    blocks_->store(*block, height, true);
+    // Store the block as confirmed, serialized once for checksum and cache.
+    auto data = block->to_data(true);
+    blocks_->store(*block, height, block_database::checksum(data), true);
+    push_unspents(*block, height);
 
     // Synchronize table and index updates.
     synchronize();
+    cache_block(block->hash(), std::move(data));
 
     // Set push end time for the block.
     block->validation.end_push = asio::steady_clock::now();
@@ -765,24 +1195,47 @@ void data_base::pop_above(block_const_ptr_list_ptr out_blocks,
 
     // If the fork is at the top there is one block to pop, and so on.
     out_blocks->reserve(size);
+    const auto start_time = asio::steady_clock::now();
+    auto popped = true;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(unspent_mutex_);
 
     // Enqueue blocks so .front() is fork + 1 and .back() is top.
-    for (size_t height = top; height > fork; --height)
+    // Blocks remain confirmed until the range is unconfirmed in one pass.
+    for (auto height = top; height > fork; --height)
     {
         message::block next;
 
-        if (!pop(next))
+        if (!pop_transactions(next, height))
         {
-            handler(error::operation_failed);
-            return;
+            popped = false;
+            break;
         }
 
         BITCOIN_ASSERT(next.is_valid());
+        next.validation.error = error::success;
+        next.validation.start_pop = start_time;
         auto block = std::make_shared<const message::block>(std::move(next));
         out_blocks->insert(out_blocks->begin(), block);
     }
 
-    handler(error::success);
+    // Unconfirm the blocks whose txs were popped (the returned blocks).
+    const auto from_height = top + 1 - out_blocks->size();
+    const auto unconfirmed = out_blocks->empty() ||
+        blocks_->unconfirm(from_height);
+
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto block: *out_blocks)
+        block_cache_.remove(block->hash());
+
+    // Synchronise everything that was changed.
+    synchronize();
+    handler(popped && unconfirmed ? error::success :
+        error::operation_failed);
 }
 
 // This is designed for write exclusivity and read concurrency.
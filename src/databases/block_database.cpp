@@ -18,12 +18,18 @@
  */
 #include <bitcoin/database/databases/block_database.hpp>
 
-#include <cstdint>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/databases/transaction_database.hpp>
 #include <bitcoin/database/define.hpp>
+#include <bitcoin/database/gap_index.hpp>
+#include <bitcoin/database/header_index.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/result/block_result.hpp>
 
@@ -101,7 +107,7 @@ inline bool is_confirmed(uint8_t value)
 // Blocks uses a hash table and two array indexes, all O(1).
 block_database::block_database(const path& map_filename,
     const path& block_index_filename, const path& tx_index_filename,
-    size_t buckets, size_t expansion, mutex_ptr mutex)
+    size_t buckets, size_t expansion, bool cache_headers, mutex_ptr mutex)
   : initial_map_file_size_(record_hash_table_header_size(buckets) +
         minimum_records_size),
 
@@ -117,7 +123,9 @@ block_database::block_database(const path& map_filename,
 
     tx_index_file_(tx_index_filename, mutex, expansion),
     tx_index_manager_(tx_index_file_, tx_index_header_size,
-        tx_index_record_size)
+        tx_index_record_size),
+
+    cache_headers_(cache_headers)
 {
 }
 
@@ -162,7 +170,7 @@ bool block_database::create()
 
 bool block_database::open()
 {
-    return
+    const auto opened =
         lookup_file_.open() &&
         block_index_file_.open() &&
         tx_index_file_.open() &&
@@ -170,6 +178,16 @@ bool block_database::open()
         lookup_manager_.start() &&
         block_index_manager_.start() &&
         tx_index_manager_.start();
+
+    if (!opened)
+        return false;
+
+    load_gaps();
+
+    if (cache_headers_)
+        load_headers();
+
+    return true;
 }
 
 bool block_database::close()
@@ -198,13 +216,25 @@ bool block_database::flush() const
 // Queries.
 // ----------------------------------------------------------------------------
 
+// The index lock is held through the metadata read, so that the result is
+// either before or after any concurrent unconfirm of the height.
 block_result block_database::get(size_t height) const
 {
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(index_mutex_);
+
     if (height >= block_index_manager_.count())
         return{ tx_index_manager_ };
 
     const auto height32 = static_cast<uint32_t>(height);
-    auto record = lookup_manager_.get(get_index(height));
+    const auto index = read_index(height32);
+
+    // Gaps have no block.
+    if (index == empty)
+        return{ tx_index_manager_ };
+
+    auto record = lookup_manager_.get(index);
     const auto prefix = REMAP_ADDRESS(record);
 
     // Advance the record row entry past the key and link to the record data.
@@ -214,21 +244,25 @@ block_result block_database::get(size_t height) const
     // The header and height never change after the block is reachable.
     deserial.skip(checksum_offset);
 
-    ///////////////////////////////////////////////////////////////////////////
-    metadata_mutex_.lock_shared();
+    // HACK: back up into the record to obtain the hash/key (optimization).
+    auto reader = make_unsafe_deserializer(prefix);
+    auto hash = reader.read_hash();
+
+    // Lock order: index_mutex_ then metadata stripe (as unconfirm).
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    auto& mutex = metadata_mutex_.get(hash);
+    mutex.lock_shared();
     const auto checksum = deserial.read_4_bytes_little_endian();
     const auto tx_start = deserial.read_4_bytes_little_endian();
     const auto tx_count = deserial.read_2_bytes_little_endian();
     const auto confirmed = is_confirmed(deserial.read_byte());
-    metadata_mutex_.unlock_shared();
-    ///////////////////////////////////////////////////////////////////////////
-
-    // HACK: back up into the record to obtain the hash/key (optimization).
-    auto reader = make_unsafe_deserializer(prefix);
+    mutex.unlock_shared();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
     // Reads are not deferred for updatable values as atomicity is required.
-    return{ tx_index_manager_, record, reader.read_hash(), height32, checksum,
+    return{ tx_index_manager_, record, std::move(hash), height32, checksum,
         tx_start, tx_count, confirmed };
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 block_result block_database::get(const hash_digest& hash,
@@ -248,12 +282,13 @@ block_result block_database::get(const hash_digest& hash,
     const auto height = deserial.read_4_bytes_little_endian();
 
     ///////////////////////////////////////////////////////////////////////////
-    metadata_mutex_.lock_shared();
+    auto& mutex = metadata_mutex_.get(hash);
+    mutex.lock_shared();
     const auto checksum = deserial.read_4_bytes_little_endian();
     const auto tx_start = deserial.read_4_bytes_little_endian();
     const auto tx_count = deserial.read_2_bytes_little_endian();
     const auto confirmed = deserial.read_byte() != 0;
-    metadata_mutex_.unlock_shared();
+    mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
     if (require_confirmed && !confirmed)
@@ -264,6 +299,128 @@ block_result block_database::get(const hash_digest& hash,
         tx_count, confirmed };
 }
 
+bool block_database::get_hash(hash_digest& out_hash, size_t height) const
+{
+    if (cache_headers_)
+        return headers_.get(out_hash, height);
+
+    if (!exists(height))
+        return false;
+
+    out_hash = get(height).hash();
+    return true;
+}
+
+bool block_database::get_header(header& out_header, size_t height) const
+{
+    if (cache_headers_)
+    {
+        header_index::entry value;
+
+        if (!headers_.get(value, height))
+            return false;
+
+        out_header = header_index::to_header(value);
+        return true;
+    }
+
+    if (!exists(height))
+        return false;
+
+    out_header = get(height).header();
+    return true;
+}
+
+header::list block_database::get_headers(size_t first, size_t count) const
+{
+    header::list headers;
+    headers.reserve(count);
+
+    for (auto height = first; height < first + count; ++height)
+    {
+        header value;
+
+        if (!get_header(value, height))
+            break;
+
+        headers.push_back(std::move(value));
+    }
+
+    return headers;
+}
+
+// Gaps are skipped by probing the next existing height within the range.
+bool block_database::get_height(size_t& out_height,
+    uint32_t median_time_past) const
+{
+    auto found = false;
+    size_t low = 0;
+    size_t high = block_index_manager_.count();
+
+    while (low < high)
+    {
+        const auto middle = low + (high - low) / 2;
+        auto index = empty;
+
+        // Jump over any run of gaps, the index is probed in case of a race.
+        auto probe = gaps_.next(middle);
+
+        while (probe < high && (index = get_index(probe)) == empty)
+            probe = gaps_.next(probe + 1);
+
+        // The upper part of the range is all gaps (a jump may pass high).
+        if (index == empty)
+        {
+            high = middle;
+            continue;
+        }
+
+        if (read_median_time_past(index) >= median_time_past)
+        {
+            out_height = probe;
+            found = true;
+            high = middle;
+        }
+        else
+        {
+            low = probe + 1;
+        }
+    }
+
+    return found;
+}
+
+bool block_database::get_locator(hash_list& out_hashes,
+    const block::indexes& heights) const
+{
+    out_hashes.clear();
+    out_hashes.reserve(heights.size());
+
+    for (const auto height: heights)
+    {
+        hash_digest hash;
+
+        if (!get_hash(hash, height))
+            return false;
+
+        out_hashes.push_back(hash);
+    }
+
+    return true;
+}
+
+// The checksum of the block message payload, computed once and stored.
+// A zero checksum cannot be distinguished from no checksum (presumed invalid).
+uint32_t block_database::checksum(const block& block)
+{
+    return checksum(block.to_data(true));
+}
+
+uint32_t block_database::checksum(const data_chunk& data)
+{
+    return bitcoin_checksum(data);
+}
+
 // Save each transaction offset into the transaction_index and return the index
 // of the first entry. Offsets must be cached in tx metadata.
 array_index block_database::associate(const transaction::list& transactions)
@@ -285,28 +442,57 @@ array_index block_database::associate(const transaction::list& transactions)
     return start;
 }
 
-// Save each transaction offset into the transaction_index and return the index
-// of the first entry. Offsets must be cached in short_id metadata.
-array_index block_database::associate(const short_id_list& ids)
+// Save each transaction short id into the transaction_index and set the
+// index of the first entry. Prefilled txs are assigned their computed short
+// ids, so that all slots are resolved uniformly against the pool.
+// Returns false, without allocation, if any prefilled index is invalid.
+bool block_database::associate(array_index& out_start,
+    const message::compact_block& compact)
 {
-    BITCOIN_ASSERT_MSG(false, "not implemented");
+    static constexpr auto unassigned = max_uint64;
+    const auto& ids = compact.short_ids();
+    const auto& prefilled = compact.transactions();
+    const auto count = ids.size() + prefilled.size();
+    out_start = 0;
 
-    if (ids.empty())
-        return 0;
+    if (count > max_uint16)
+        return false;
 
-    const auto start = tx_index_manager_.new_records(ids.size());
-    const auto record = tx_index_manager_.get(start);
-    auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
+    if (count == 0)
+        return true;
+
+    const auto key = short_id_key(compact);
+    offset_list slots(count, unassigned);
+
+    // Prefilled indexes are differentially encoded (bip152), each relative to
+    // the slot following the previous, and must not pass the last slot.
+    uint64_t next = 0;
 
-    for (const auto& id: ids)
+    for (const auto& tx: prefilled)
     {
-        // TODO: create and employ short_id type with offset metadata.
-        ////const auto offset = id.validation.offset;
-        ////BITCOIN_ASSERT(offset != slab_map::not_found);
-        ////serial.write_8_bytes_little_endian(offset);
+        if (tx.index() >= count - next)
+            return false;
+
+        const auto position = next + tx.index();
+        slots[position] = short_id_tag |
+            to_short_id(key, tx.transaction().hash());
+        next = position + 1;
     }
 
-    return start;
+    auto id = ids.begin();
+
+    for (auto& slot: slots)
+        if (slot == unassigned && id != ids.end())
+            slot = short_id_tag | to_short_id(*id++);
+
+    out_start = tx_index_manager_.new_records(count);
+    const auto record = tx_index_manager_.get(out_start);
+    auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
+
+    for (const auto slot: slots)
+        serial.write_8_bytes_little_endian(slot);
+
+    return true;
 }
 
 // Store.
@@ -350,22 +536,69 @@ void block_database::store(const chain::header& header, size_t height)
     store(header, height, no_checksum, 0, tx_count, false);
 }
 
+// The run is allocated contiguously, so record indexes follow header order.
+void block_database::store(const header::list& headers, size_t first_height,
+    bool confirmed)
+{
+    if (headers.empty())
+        return;
+
+    BITCOIN_ASSERT(first_height + headers.size() <= max_uint32);
+    const auto height32 = static_cast<array_index>(first_height);
+
+    record_map::key_list keys;
+    keys.reserve(headers.size());
+
+    for (const auto& header: headers)
+        keys.push_back(header.hash());
+
+    // Store creates new entries, and supports parallel, so no locking.
+    const auto write = [&](byte_serializer& serial, size_t position)
+    {
+        headers[position].to_data(serial, false);
+        serial.write_4_bytes_little_endian(
+            static_cast<uint32_t>(first_height + position));
+        serial.write_4_bytes_little_endian(no_checksum);
+        serial.write_4_bytes_little_endian(0);
+        serial.write_2_bytes_little_endian(0);
+        serial.write_byte(to_status(confirmed));
+    };
+
+    const auto first = lookup_map_.store(keys, write);
+
+    if (!confirmed)
+        return;
+
+    write_index(first, height32, headers.size());
+}
+
 void block_database::store(const chain::block& block, size_t height,
     bool confirmed)
 {
-    // TODO: cache block.checksum() from message.
-    const auto checksum = no_checksum;
+    store(block, height, checksum(block), confirmed);
+}
+
+void block_database::store(const chain::block& block, size_t height,
+    uint32_t checksum, bool confirmed)
+{
     const auto& header = block.header();
     const auto& txs = block.transactions();
     store(header, height, checksum, associate(txs), txs.size(), confirmed);
 }
 
-void block_database::store(const message::compact_block& compact,
-    size_t height, bool confirmed)
+// A compact block is never confirmed, as it has no tx offsets to unconfirm.
+bool block_database::store(const message::compact_block& compact,
+    size_t height)
 {
-    const auto& header = compact.header();
-    const auto& ids = compact.short_ids();
-    store(header, height, no_checksum, associate(ids), ids.size(), confirmed);
+    array_index tx_start;
+
+    if (!associate(tx_start, compact))
+        return false;
+
+    const auto count = compact.short_ids().size() +
+        compact.transactions().size();
+    store(compact.header(), height, no_checksum, tx_start, count, false);
+    return true;
 }
 
 // Update.
@@ -389,7 +622,7 @@ bool block_database::update(const hash_digest& hash, size_t height,
 
         ///////////////////////////////////////////////////////////////////////
         // Critical Section
-        unique_lock lock(metadata_mutex_);
+        unique_lock lock(metadata_mutex_.get(hash));
         serial.write_4_bytes_little_endian(checksum);
         serial.write_4_bytes_little_endian(tx_start32);
         serial.write_2_bytes_little_endian(tx_count16);
@@ -413,20 +646,23 @@ bool block_database::update(const hash_digest& hash, size_t height,
 bool block_database::update(const chain::block& block, size_t height,
     bool confirmed)
 {
-    // TODO: cache block.checksum() from message.
-    const auto checksum = no_checksum;
-
     const auto& txs = block.transactions();
-    return update(block.hash(), height, checksum, associate(txs), txs.size(),
-        confirmed);
+    return update(block.hash(), height, checksum(block), associate(txs),
+        txs.size(), confirmed);
 }
 
 bool block_database::update(const message::compact_block& compact,
-    size_t height, bool confirmed)
+    size_t height)
 {
-    const auto& ids = compact.short_ids();
-    return update(compact.header().hash(), height, no_checksum, associate(ids),
-        ids.size(), confirmed);
+    array_index tx_start;
+
+    if (!associate(tx_start, compact))
+        return false;
+
+    const auto count = compact.short_ids().size() +
+        compact.transactions().size();
+    return update(compact.header().hash(), height, no_checksum, tx_start,
+        count, false);
 }
 
 // Confirm.
@@ -440,7 +676,7 @@ bool block_database::confirm(const hash_digest& hash, bool confirm)
 
         ///////////////////////////////////////////////////////////////////////
         // Critical Section
-        unique_lock lock(metadata_mutex_);
+        unique_lock lock(metadata_mutex_.get(hash));
         serial.write_byte(to_status(confirm));
         ///////////////////////////////////////////////////////////////////////
     };
@@ -448,20 +684,73 @@ bool block_database::confirm(const hash_digest& hash, bool confirm)
     return lookup_map_.update(hash, update) != record_map::not_found;
 }
 
+// Confirmation state is written directly through the block index records,
+// avoiding a hash table walk for each height. Lock order is index_mutex_ then
+// metadata stripes, as for get(height); no stripe is held when taking the
+// index lock.
 bool block_database::unconfirm(size_t from_height)
 {
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(index_mutex_);
     const auto count = block_index_manager_.count();
 
     if (from_height >= count)
         return false;
 
-    for (auto height = from_height; height < count; ++height)
-        if (!confirm(get(height).hash(), false))
-            return false;
+    std::vector<array_index> indexes;
+    indexes.reserve(count - from_height);
+
+    // The index accessor is released before the block records are accessed.
+    {
+        const auto record = block_index_manager_.get(from_height);
+        auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(record));
+
+        for (auto height = from_height; height < count; ++height)
+            indexes.push_back(deserial.read_4_bytes_little_endian());
+    }
+
+    // A range spanning fewer blocks than stripes locks only their stripes.
+    const auto all_stripes = indexes.size() >= metadata_mutex_.size();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////
+    if (all_stripes)
+        metadata_mutex_.lock();
+
+    for (const auto index: indexes)
+    {
+        // Gaps have no block to unconfirm.
+        if (index == empty)
+            continue;
+
+        auto record = lookup_manager_.get(index);
+
+        // The record key (block hash) selects the stripe.
+        auto reader = make_unsafe_deserializer(REMAP_ADDRESS(record));
+        const auto hash = reader.read_hash();
+        REMAP_INCREMENT(record, prefix_size + block_size - confirmed_size);
+
+        if (all_stripes)
+        {
+            *REMAP_ADDRESS(record) = to_status(false);
+            continue;
+        }
+
+        unique_lock lock(metadata_mutex_.get(hash));
+        *REMAP_ADDRESS(record) = to_status(false);
+    }
+
+    if (all_stripes)
+        metadata_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////
 
     // This will remove from the index all references at and above from_height.
-    block_index_manager_.set_count(from_height);
+    block_index_manager_.set_count(static_cast<array_index>(from_height));
+    gaps_.truncate(from_height);
+    headers_.truncate(from_height);
     return true;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Parallel.
@@ -483,31 +772,41 @@ bool block_database::exists(size_t height) const
 // Check for gaps following parallel write (i.e. restart).
 bool block_database::gaps(heights& out_gaps) const
 {
-    const auto count = block_index_manager_.count();
-
-    for (size_t height = 0; height < count; ++height)
-        if (get_index(height) == empty)
-            out_gaps.push_back(height);
-
+    gaps_.get(out_gaps);
     return true;
 }
 
+gap_index::ranges block_database::missing() const
+{
+    return gaps_.get();
+}
+
 // This is necessary for parallel import, as gaps are created.
+// Index records are contiguous, so the range is written sequentially.
 void block_database::zeroize(array_index first, array_index count)
 {
-    for (auto index = first; index < (first + count); ++index)
-    {
-        const auto record = block_index_manager_.get(index);
-        auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
+    if (count == 0)
+        return;
+
+    const auto record = block_index_manager_.get(first);
+    auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
+
+    for (array_index index = 0; index < count; ++index)
         serial.write_4_bytes_little_endian(empty);
-    }
 }
 
-// The lock is necessary for parallel import and otherwise inconsequential.
 void block_database::write_index(array_index index, array_index height)
 {
-    BITCOIN_ASSERT(height < max_uint32);
-    const auto new_count = height + 1;
+    write_index(index, height, 1);
+}
+
+// The lock is necessary for parallel import and otherwise inconsequential.
+void block_database::write_index(array_index first_index,
+    array_index first_height, size_t count)
+{
+    BITCOIN_ASSERT(count > 0);
+    BITCOIN_ASSERT(first_height + count <= max_uint32);
+    const auto new_count = static_cast<array_index>(first_height + count);
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
@@ -522,31 +821,118 @@ void block_database::write_index(array_index index, array_index height)
     // Guard write to prevent overwriting preceding height write.
     if (new_count > initial_count)
     {
-        const auto create_count = new_count - initial_count;
-        block_index_manager_.new_records(create_count);
-        zeroize(initial_count, create_count - 1);
+        block_index_manager_.new_records(new_count - initial_count);
+
+        if (first_height > initial_count)
+        {
+            const auto gap = first_height - initial_count;
+            zeroize(initial_count, gap);
+            gaps_.insert(initial_count, gap);
+        }
     }
 
+    // The run may fill previously-created gaps.
+    if (first_height < initial_count)
+        gaps_.erase(first_height, count);
+
     // Guard write to prevent subsequent zeroize from erasing.
-    const auto record = block_index_manager_.get(height);
+    // Index records are contiguous, so the run is written sequentially.
+    const auto record = block_index_manager_.get(first_height);
     auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
-    serial.write_4_bytes_little_endian(index);
+
+    for (size_t offset = 0; offset < count; ++offset)
+        serial.write_4_bytes_little_endian(
+            static_cast<array_index>(first_index + offset));
 
     index_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
+
+    if (!cache_headers_)
+        return;
+
+    for (size_t offset = 0; offset < count; ++offset)
+        headers_.set(first_height + offset,
+            read_entry(static_cast<array_index>(first_index + offset)));
 }
 
 array_index block_database::get_index(array_index height) const
 {
-    const auto record = block_index_manager_.get(height);
-
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     shared_lock lock(index_mutex_);
-    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(record));
+    return read_index(height);
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// The caller must hold index_mutex_ (it is not recursive).
+array_index block_database::read_index(array_index height) const
+{
+    const auto record = block_index_manager_.get(height);
+    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(record));
+}
+
+// The median time past never changes after the block is reachable.
+uint32_t block_database::read_median_time_past(array_index index) const
+{
+    const auto record = lookup_manager_.get(index);
+    const auto memory = REMAP_ADDRESS(record) + prefix_size + header_size;
+    return from_little_endian_unsafe<uint32_t>(memory);
+}
+
+// The header and its hash (key) never change after the block is reachable.
+header_index::entry block_database::read_entry(array_index index) const
+{
+    header_index::entry value;
+    const auto record = lookup_manager_.get(index);
+    const auto memory = REMAP_ADDRESS(record);
+    auto reader = make_unsafe_deserializer(memory);
+    value.hash = reader.read_hash();
+    const auto data = memory + prefix_size;
+    std::copy(data, data + header_size, value.header.begin());
+    return value;
+}
+
+// This is the only full scan of the block index, performed once at open.
+void block_database::load_gaps()
+{
+    const auto count = block_index_manager_.count();
+    gaps_.clear();
+
+    // Adjacent heights are merged into ranges by the gap index.
+    for (array_index height = 0; height < count; ++height)
+        if (get_index(height) == empty)
+            gaps_.insert(height, 1);
+}
+
+// Heights are partitioned among threads, as each read is independent.
+void block_database::load_headers()
+{
+    const size_t count = block_index_manager_.count();
+    const size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    const auto partition = (count + threads - 1) / threads;
+    header_index::list entries(count);
+    std::vector<std::thread> workers;
+
+    const auto load = [&](size_t first, size_t last)
+    {
+        for (auto height = first; height < last; ++height)
+        {
+            const auto index = get_index(height);
+
+            if (index != empty)
+                entries[height] = read_entry(index);
+        }
+    };
+
+    for (size_t first = 0; first < count; first += partition)
+        workers.emplace_back(load, first, std::min(first + partition, count));
+
+    for (auto& worker: workers)
+        worker.join();
+
+    headers_.assign(std::move(entries));
+}
+
 // The height of the highest existing block, independent of gaps.
 bool block_database::top(size_t& out_height) const
 {
@@ -18,13 +18,15 @@
  */
 #include <bitcoin/database/databases/history_database.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/primitives/record_hash_table.hpp>
 #include <bitcoin/database/primitives/record_multimap.hpp>
-#include <bitcoin/database/primitives/record_multimap_iterable.hpp>
+#include <bitcoin/database/primitives/record_list.hpp>
+#include <bitcoin/database/primitives/record_multimap_iterator.hpp>
 
 // Record format (v4) [47 bytes]:
 // ----------------------------------------------------------------------------
@@ -34,6 +36,15 @@
 // [ point-index:2 - const]
 // [ data:8        - const]
 
+// Summary format [29 bytes] (follows the head row index in the lookup table):
+// ----------------------------------------------------------------------------
+// [ rows:4         - atomic]
+// [ received:8     - atomic]
+// [ spent:8        - atomic]
+// [ min_height:4   - atomic]
+// [ max_height:4   - atomic]
+// [ unordered:1    - atomic] (zero until a row is stored below max_height)
+
 // Record format (v3) [47 bytes]:
 // ----------------------------------------------------------------------------
 // [ kind:1        - const]
@@ -56,10 +67,17 @@ static constexpr auto checksum_size = sizeof(uint64_t);
 static constexpr auto value_size = height_size + flag_size + point_size +
     checksum_size;
 
+static constexpr auto rows_size = sizeof(uint32_t);
+static constexpr auto total_size = sizeof(uint64_t);
+static constexpr auto summary_size = rows_size + 2 * total_size +
+    2 * height_size + flag_size;
+
 static BC_CONSTEXPR auto table_record_size =
-    hash_table_multimap_record_size<short_hash>();
+    hash_table_multimap_record_size<short_hash>(summary_size);
 static const auto row_record_size = multimap_record_size(value_size);
 
+const array_index history_database::end_of_history = record_list::empty;
+
 // History uses a hash table index, O(1).
 history_database::history_database(const path& lookup_filename,
     const path& rows_filename, size_t buckets, size_t expansion,
@@ -75,7 +93,7 @@ history_database::history_database(const path& lookup_filename,
 
     rows_file_(rows_filename, mutex, expansion),
     rows_manager_(rows_file_, rows_header_size, row_record_size),
-    rows_multimap_(lookup_map_, rows_manager_)
+    rows_multimap_(lookup_map_, rows_manager_, summary_size)
 {
 }
 
@@ -144,47 +162,264 @@ bool history_database::flush() const
         rows_file_.flush();
 }
 
+// Summary.
+// ----------------------------------------------------------------------------
+
+static history_summary read_summary(const uint8_t* memory)
+{
+    auto deserial = make_unsafe_deserializer(memory);
+    const size_t rows = deserial.read_4_bytes_little_endian();
+    const auto received = deserial.read_8_bytes_little_endian();
+    const auto spent = deserial.read_8_bytes_little_endian();
+    const size_t min_height = deserial.read_4_bytes_little_endian();
+    const size_t max_height = deserial.read_4_bytes_little_endian();
+    const auto ordered = deserial.read_byte() == 0;
+    return{ rows, received, spent, min_height, max_height, ordered };
+}
+
+static void write_summary(uint8_t* memory, const history_summary& summary)
+{
+    auto serial = make_unsafe_serializer(memory);
+    serial.write_4_bytes_little_endian(static_cast<uint32_t>(summary.rows));
+    serial.write_8_bytes_little_endian(summary.received);
+    serial.write_8_bytes_little_endian(summary.spent);
+    serial.write_4_bytes_little_endian(
+        static_cast<uint32_t>(summary.min_height));
+    serial.write_4_bytes_little_endian(
+        static_cast<uint32_t>(summary.max_height));
+    serial.write_byte(summary.ordered ? 0 : 1);
+}
+
+// Rows stored out of height order (e.g. by parallel block insert) require a
+// scan of the rows to restore the heights of a summary on unlink.
+void history_database::scan_heights(history_summary& summary,
+    array_index index) const
+{
+    summary.min_height = max_uint32;
+    summary.max_height = 0;
+    record_multimap_iterator row(rows_manager_, index);
+    const record_multimap_iterator end(rows_manager_, end_of_history);
+
+    for (; row != end; ++row)
+    {
+        const auto record = rows_multimap_.get(*row);
+        const size_t height = from_little_endian_unsafe<uint32_t>(
+            REMAP_ADDRESS(record));
+        summary.min_height = std::min(summary.min_height, height);
+        summary.max_height = std::max(summary.max_height, height);
+    }
+}
+
 // Queries.
 // ----------------------------------------------------------------------------
 
+history_summary history_database::get_summary(const short_hash& key) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(summary_mutex_.get(key));
+    const auto memory = rows_multimap_.summary(key);
+
+    if (!memory)
+        return{ 0, 0, 0, 0, 0, true };
+
+    return read_summary(REMAP_ADDRESS(memory));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 history_database::list history_database::get(const short_hash& key,
     size_t limit, size_t from_height) const
 {
     list result;
+
+    const auto handler = [&](const payment_record& payment)
+    {
+        result.push_back(payment);
+        return true;
+    };
+
+    get(key, limit, from_height, handler);
+    return result;
+}
+
+array_index history_database::get(const short_hash& key, size_t limit,
+    size_t from_height, row_handler handler) const
+{
+    array_index head;
+    auto ordered = false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        shared_lock lock(summary_mutex_.get(key));
+        head = rows_multimap_.find(key);
+
+        if (head == end_of_history)
+            return end_of_history;
+
+        const auto memory = rows_multimap_.summary(key);
+        ordered = read_summary(REMAP_ADDRESS(memory)).ordered;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Rows below the head are immutable, so the walk requires no lock.
+    return walk(head, limit, from_height, ordered, handler);
+}
+
+array_index history_database::get(array_index cursor, size_t limit,
+    size_t from_height, row_handler handler) const
+{
+    // The cursor may be stale or client supplied.
+    if (cursor >= rows_manager_.count())
+        return end_of_history;
+
+    return walk(cursor, limit, from_height, false, handler);
+}
+
+// The cursor is the row index of the next unvisited row, so resuming a walk
+// neither re-walks the chain nor requires the address key. Rows are prepended
+// as blocks are pushed, so the chain is usually ordered by descending height
+// and the walk can end at the first row below from_height, costing O(result).
+// Blocks inserted out of order leave the chain unordered (see summary).
+array_index history_database::walk(array_index cursor, size_t limit,
+    size_t from_height, bool ordered, row_handler handler) const
+{
+    size_t count = 0;
     payment_record payment;
-    const auto start = rows_multimap_.find(key);
-    const auto records = record_multimap_iterable(rows_manager_, start);
+    record_multimap_iterator row(rows_manager_, cursor);
+    const record_multimap_iterator end(rows_manager_, end_of_history);
 
-    for (const auto index: records)
+    while (row != end)
     {
-        if (limit > 0 && result.size() >= limit)
+        if (limit > 0 && count >= limit)
+            return *row;
+
+        const auto record = rows_multimap_.get(*row);
+        const auto memory = REMAP_ADDRESS(record);
+
+        // The height leads the row so the walk can stop without a full read.
+        if (ordered && from_little_endian_unsafe<uint32_t>(memory) <
+            from_height)
             break;
 
-        const auto record = rows_multimap_.get(index);
-        auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(record));
+        auto deserial = make_unsafe_deserializer(memory);
 
         // Failed reads are conflated with skipped returns.
-        if (payment.from_data(deserial, from_height))
-            result.push_back(payment);
+        const auto found = payment.from_data(deserial, from_height);
+        ++row;
+
+        if (!found)
+            continue;
+
+        ++count;
+
+        if (!handler(payment))
+            return *row;
     }
 
-    return result;
+    return end_of_history;
 }
 
 void history_database::store(const short_hash& key,
-    const payment_record& payment)
+    const payment_record& payment, uint64_t spent)
 {
     const auto write = [&](byte_serializer& serial)
     {
         payment.to_data(serial, false);
     };
 
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(summary_mutex_.get(key));
     rows_multimap_.store(key, write);
+
+    // The summary is zeroed when the key is created.
+    const auto memory = rows_multimap_.summary(key);
+    const auto address = REMAP_ADDRESS(memory);
+    auto summary = read_summary(address);
+    const auto height = payment.height();
+
+    if (summary.rows++ == 0)
+    {
+        summary.min_height = height;
+        summary.max_height = height;
+    }
+    else
+    {
+        summary.ordered = summary.ordered && height >= summary.max_height;
+        summary.min_height = std::min(summary.min_height, height);
+        summary.max_height = std::max(summary.max_height, height);
+    }
+
+    if (payment.is_output())
+        summary.received = ceiling_add(summary.received, payment.data());
+    else
+        summary.spent = ceiling_add(summary.spent, spent);
+
+    write_summary(address, summary);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
-bool history_database::unlink_last_row(const short_hash& key)
+bool history_database::unlink_last_row(const short_hash& key, uint64_t spent)
 {
-    return rows_multimap_.unlink(key);
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(summary_mutex_.get(key));
+    const auto head = rows_multimap_.find(key);
+
+    if (head == end_of_history)
+        return false;
+
+    payment_record payment;
+
+    // Release the row before unlinking.
+    {
+        const auto row = rows_multimap_.get(head);
+        auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(row));
+
+        if (!payment.from_data(deserial, 0))
+            return false;
+    }
+
+    if (!rows_multimap_.unlink(key))
+        return false;
+
+    // The key and its summary are removed with its only row.
+    const auto next = rows_multimap_.find(key);
+
+    if (next == end_of_history)
+        return true;
+
+    history_summary summary;
+    {
+        const auto memory = rows_multimap_.summary(key);
+        summary = read_summary(REMAP_ADDRESS(memory));
+    }
+
+    summary.rows--;
+    const auto height = payment.height();
+
+    if (payment.is_output())
+        summary.received = floor_subtract(summary.received, payment.data());
+    else
+        summary.spent = floor_subtract(summary.spent, spent);
+
+    if (summary.ordered)
+    {
+        // The height leads the row, and the next row is now the highest.
+        const auto row = rows_multimap_.get(next);
+        summary.max_height = from_little_endian_unsafe<uint32_t>(
+            REMAP_ADDRESS(row));
+    }
+    else if (height == summary.min_height || height == summary.max_height)
+    {
+        scan_heights(summary, next);
+    }
+
+    const auto memory = rows_multimap_.summary(key);
+    write_summary(REMAP_ADDRESS(memory), summary);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 history_statinfo history_database::statinfo() const
@@ -18,12 +18,19 @@
  */
 #include <bitcoin/database/databases/transaction_database.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/compression.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/result/transaction_result.hpp>
+#include <bitcoin/database/short_ids.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -41,6 +48,10 @@ using namespace bc::machine;
 // [ [ hash:32 ][ index:2 ][ script:varint ][ sequence:4 ] ... - const ]
 // [ locktime:varint     - const  ]
 // [ version:varint      - const  ]
+//
+// If compressed each output is stored as:
+// [ [ spender_height:4  - atomic ] [ value:varint ][ script:code ] - const ]
+// A value above max_money is stored as [ amount_escape:varint ][ value:8 ].
 
 static BC_CONSTEXPR auto prefix_size = slab_row<hash_digest>::prefix_size;
 static constexpr auto value_size = sizeof(uint64_t);
@@ -51,21 +62,82 @@ static constexpr auto spender_height_value_size = height_size + value_size;
 static constexpr auto metadata_size = height_size + position_size +
     median_time_past_size;
 
+// Write the stored form of the transaction with compressed outputs.
+static void to_compressed_data(writer& sink, const transaction& tx)
+{
+    const auto& outputs = tx.outputs();
+    sink.write_variable_little_endian(outputs.size());
+
+    for (const auto& output: outputs)
+    {
+        sink.write_4_bytes_little_endian(output.validation.spender_height);
+        compress_amount(sink, output.value());
+        compress_script(sink, output.script());
+    }
+
+    const auto& inputs = tx.inputs();
+    sink.write_variable_little_endian(inputs.size());
+
+    for (const auto& input: inputs)
+        input.to_data(sink, false);
+
+    sink.write_variable_little_endian(tx.locktime());
+    sink.write_variable_little_endian(tx.version());
+}
+
+// The stored size of the transaction with compressed outputs.
+static size_t compressed_size(const transaction& tx)
+{
+    const auto& outputs = tx.outputs();
+    const auto& inputs = tx.inputs();
+
+    auto size =
+        variable_uint_size(outputs.size()) +
+        variable_uint_size(inputs.size()) +
+        variable_uint_size(tx.locktime()) +
+        variable_uint_size(tx.version());
+
+    for (const auto& output: outputs)
+        size += height_size +
+            compressed_amount_size(output.value()) +
+            compressed_script_size(output.script());
+
+    for (const auto& input: inputs)
+        size += input.serialized_size(false);
+
+    return size;
+}
+
 // Valid tx position should never reach 2^16.
 const size_t transaction_database::unconfirmed = max_uint16;
 
 // Transactions uses a hash table index, O(1).
 transaction_database::transaction_database(const path& map_filename,
-    size_t buckets, size_t expansion, size_t cache_capacity, mutex_ptr mutex)
+    const path& pool_filename, const path& pool_index_filename,
+    size_t buckets, size_t pool_buckets, size_t expansion,
+    size_t cache_bytes, eviction_policy cache_policy, bool compress,
+    mutex_ptr mutex)
   : initial_map_file_size_(slab_hash_table_header_size(buckets) +
         minimum_slabs_size),
+    initial_pool_file_size_(slab_hash_table_header_size(pool_buckets) +
+        minimum_slabs_size),
+    compress_(compress),
 
     lookup_file_(map_filename, mutex, expansion),
     lookup_header_(lookup_file_, buckets),
     lookup_manager_(lookup_file_, slab_hash_table_header_size(buckets)),
     lookup_map_(lookup_header_, lookup_manager_),
 
-    cache_(cache_capacity)
+    pool_file_(pool_filename, mutex, expansion),
+    pool_header_(pool_file_, pool_buckets),
+    pool_manager_(pool_file_, slab_hash_table_header_size(pool_buckets)),
+    pool_map_(pool_header_, pool_manager_),
+
+    pool_index_file_(pool_index_filename, mutex, expansion),
+    pool_index_(pool_index_file_),
+    short_ids_keyed_(false),
+
+    cache_(cache_bytes, cache_policy)
 {
 }
 
@@ -81,20 +153,30 @@ transaction_database::~transaction_database()
 bool transaction_database::create()
 {
     // Resize and create require an opened file.
-    if (!lookup_file_.open())
+    if (!lookup_file_.open() ||
+        !pool_file_.open() ||
+        !pool_index_file_.open())
         return false;
 
-    // This will throw if insufficient disk space.
+    // These will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size_);
+    pool_file_.resize(initial_pool_file_size_);
+    pool_index_file_.resize(minimum_records_size);
 
     if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+        !lookup_manager_.create() ||
+        !pool_header_.create() ||
+        !pool_manager_.create() ||
+        !pool_index_.create())
         return false;
 
     // Should not call start after create, already started.
     return
         lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_manager_.start() &&
+        pool_header_.start() &&
+        pool_manager_.start() &&
+        pool_index_.start();
 }
 
 // Startup and shutdown.
@@ -104,23 +186,36 @@ bool transaction_database::open()
 {
     return
         lookup_file_.open() &&
+        pool_file_.open() &&
+        pool_index_file_.open() &&
         lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_manager_.start() &&
+        pool_header_.start() &&
+        pool_manager_.start() &&
+        pool_index_.start();
 }
 
 bool transaction_database::close()
 {
-    return lookup_file_.close();
+    return
+        lookup_file_.close() &&
+        pool_file_.close() &&
+        pool_index_file_.close();
 }
 
 void transaction_database::synchronize()
 {
     lookup_manager_.sync();
+    pool_manager_.sync();
+    pool_index_.sync();
 }
 
 bool transaction_database::flush() const
 {
-    return lookup_file_.flush();
+    return
+        lookup_file_.flush() &&
+        pool_file_.flush() &&
+        pool_index_file_.flush();
 }
 
 // Queries.
@@ -137,7 +232,11 @@ memory_ptr transaction_database::find(const hash_digest& hash,
     //*************************************************************************
     auto slab = lookup_map_.find(hash /*, fork_height, require_confirmed*/);
 
-    if (slab == nullptr || !require_confirmed)
+    // Pool transactions are never confirmed.
+    if (slab == nullptr)
+        return require_confirmed ? nullptr : pool_map_.find(hash);
+
+    if (!require_confirmed)
         return slab;
 
     // If position is unconfirmed then height is the forks used for validation.
@@ -145,11 +244,12 @@ memory_ptr transaction_database::find(const hash_digest& hash,
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    metadata_mutex_.lock_shared();
+    auto& mutex = metadata_mutex_.get(hash);
+    mutex.lock_shared();
     const auto height = deserial.read_4_bytes_little_endian();
     const auto position = deserial.read_2_bytes_little_endian();
     ////const auto median_time_past = deserial.read_4_bytes_little_endian();
-    metadata_mutex_.unlock_shared();
+    mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
     const auto confirmed = (position != unconfirmed);
@@ -167,20 +267,23 @@ transaction_result transaction_database::get(file_offset offset) const
     const auto memory = REMAP_ADDRESS(slab);
     auto deserial = make_unsafe_deserializer(memory);
 
+    // HACK: back up into the slab to obtain the hash/key (optimization).
+    auto reader = make_unsafe_deserializer(memory - prefix_size);
+    auto hash = reader.read_hash();
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    metadata_mutex_.lock_shared();
+    auto& mutex = metadata_mutex_.get(hash);
+    mutex.lock_shared();
     const auto height = deserial.read_4_bytes_little_endian();
     const auto position = deserial.read_2_bytes_little_endian();
     const auto median_time_past = deserial.read_4_bytes_little_endian();
-    metadata_mutex_.unlock_shared();
+    mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
-    // HACK: back up into the slab to obtain the hash/key (optimization).
-    auto reader = make_unsafe_deserializer(memory - prefix_size);
-
     // Reads are not deferred for updatable values as atomicity is required.
-    return{ slab, reader.read_hash(), height, median_time_past, position };
+    return{ slab, std::move(hash), height, median_time_past, position,
+        compress_ };
 }
 
 transaction_result transaction_database::get(const hash_digest& hash,
@@ -196,15 +299,174 @@ transaction_result transaction_database::get(const hash_digest& hash,
     auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(slab));
 
     ///////////////////////////////////////////////////////////////////////////
-    metadata_mutex_.lock_shared();
+    auto& mutex = metadata_mutex_.get(hash);
+    mutex.lock_shared();
     const auto height = deserial.read_4_bytes_little_endian();
     const auto position = deserial.read_2_bytes_little_endian();
     const auto median_time_past = deserial.read_4_bytes_little_endian();
-    metadata_mutex_.unlock_shared();
+    mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
     // Reads are not deferred for updatable values as atomicity is required.
-    return{ slab, hash, height, median_time_past, position };
+    return{ slab, hash, height, median_time_past, position, compress_ };
+}
+
+bool transaction_database::get_data(writer& sink, const hash_digest& hash,
+    size_t fork_height, bool require_confirmed) const
+{
+    const auto result = get(hash, fork_height, require_confirmed);
+
+    if (!result)
+        return false;
+
+    result.to_data(sink);
+    return true;
+}
+
+bool transaction_database::get_data(data_chunk& out_data,
+    const hash_digest& hash, size_t fork_height, bool require_confirmed) const
+{
+    const auto result = get(hash, fork_height, require_confirmed);
+
+    if (!result)
+        return false;
+
+    out_data.resize(result.serialized_size());
+    auto serial = make_unsafe_serializer(out_data.begin());
+    result.to_data(serial);
+    return true;
+}
+
+transaction_result::list transaction_database::get_transactions(
+    const block_result& block) const
+{
+    const auto offsets = block.transaction_offsets();
+
+    if (offsets.size() != block.transaction_count())
+        return{};
+
+    transaction_result::list results;
+    results.reserve(offsets.size());
+
+    for (const auto offset: offsets)
+    {
+        auto result = get(offset);
+
+        if (!result)
+            return{};
+
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
+
+bool transaction_database::get_block_data(writer& sink,
+    const block_result& block) const
+{
+    const auto offsets = block.transaction_offsets();
+
+    if (!block || offsets.size() != block.transaction_count())
+        return false;
+
+    block.header().to_data(sink, true);
+    sink.write_variable_little_endian(offsets.size());
+
+    for (const auto offset: offsets)
+    {
+        const auto result = get(offset);
+
+        if (!result)
+            return false;
+
+        result.to_data(sink);
+    }
+
+    return true;
+}
+
+hash_list transaction_database::unconfirmed_hashes() const
+{
+    return pool_index_.hashes();
+}
+
+size_t transaction_database::unconfirmed_count() const
+{
+    return pool_index_.size();
+}
+
+// Short ids are computed for all unconfirmed txs under the block key (bip152).
+// The map is built once per key, after which pool changes are applied to it.
+size_t transaction_database::resolve(hash_list& out_hashes,
+    const short_id_list& ids, const siphash_key& key) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(short_ids_mutex_);
+
+    if (!short_ids_keyed_ || short_ids_key_ != key)
+    {
+        const auto hashes = unconfirmed_hashes();
+        short_ids_.clear();
+        short_ids_.reserve(hashes.size());
+
+        for (const auto& hash: hashes)
+            short_ids_.emplace(to_short_id(key, hash), hash);
+
+        short_ids_key_ = key;
+        short_ids_keyed_ = true;
+    }
+
+    size_t resolved = 0;
+    out_hashes.clear();
+    out_hashes.reserve(ids.size());
+
+    for (const auto id: ids)
+    {
+        // Colliding short ids are ambiguous and cannot be resolved.
+        const auto found = short_ids_.count(id) == 1;
+        out_hashes.push_back(found ? short_ids_.find(id)->second : null_hash);
+        resolved += found ? 1 : 0;
+    }
+
+    return resolved;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The short id lock spans the set change, so a concurrent rebuild cannot
+// observe the hash before it is also applied to the map.
+void transaction_database::index_pool(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(short_ids_mutex_);
+
+    if (pool_index_.insert(hash) && short_ids_keyed_)
+        short_ids_.emplace(to_short_id(short_ids_key_, hash), hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_database::unindex_pool(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(short_ids_mutex_);
+
+    if (!pool_index_.remove(hash) || !short_ids_keyed_)
+        return;
+
+    const auto range = short_ids_.equal_range(to_short_id(short_ids_key_,
+        hash));
+
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == hash)
+        {
+            short_ids_.erase(it);
+            break;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 bool transaction_database::get_output(output& out_output, size_t& out_height,
@@ -225,28 +487,173 @@ bool transaction_database::get_output(output& out_output, size_t& out_height,
     auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(slab));
 
     ///////////////////////////////////////////////////////////////////////////
-    metadata_mutex_.lock_shared();
+    auto& mutex = metadata_mutex_.get(point.hash());
+    mutex.lock_shared();
     out_height = deserial.read_4_bytes_little_endian();
     out_coinbase = deserial.read_2_bytes_little_endian() == 0;
     out_median_time_past = deserial.read_4_bytes_little_endian();
-    metadata_mutex_.unlock_shared();
+    mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
     // Result is used only to parse the output.
-    transaction_result result(slab, point.hash(), 0, 0, 0);
+    transaction_result result(slab, point.hash(), 0, 0, 0, compress_);
     out_output = result.output(point.index());
     return true;
 }
 
+// Cache hits are resolved in input order, misses in confirmed table order.
+size_t transaction_database::get_outputs(const block& block,
+    size_t fork_height, bool require_confirmed) const
+{
+    typedef std::pair<file_offset, const output_point*> prevout;
+
+    const auto& txs = block.transactions();
+
+    if (txs.empty())
+        return 0;
+
+    size_t populated = 0;
+    std::vector<prevout> misses;
+    std::unordered_map<hash_digest, file_offset> offsets;
+
+    // The coinbase has no prevouts.
+    for (auto tx = std::next(txs.begin()); tx != txs.end(); ++tx)
+    {
+        for (const auto& input: tx->inputs())
+        {
+            const auto& point = input.previous_output();
+            auto& prevout = point.validation;
+            prevout.cache = output{};
+
+            if (cache_.get(prevout.cache, prevout.height,
+                prevout.median_time_past, prevout.coinbase, point,
+                fork_height, require_confirmed))
+            {
+                ++populated;
+                continue;
+            }
+
+            // Look up each distinct prevout tx only once.
+            const auto entry = offsets.emplace(point.hash(),
+                slab_map::not_found);
+
+            if (entry.second)
+                entry.first->second = lookup_map_.offset(point.hash());
+
+            misses.emplace_back(entry.first->second, &point);
+        }
+    }
+
+    // Pool (not_found) prevouts sort last, otherwise ascending offset order.
+    std::stable_sort(misses.begin(), misses.end(),
+        [](const prevout& left, const prevout& right)
+        {
+            return left.first < right.first;
+        });
+
+    for (const auto& miss: misses)
+    {
+        const auto& point = *miss.second;
+        auto& prevout = point.validation;
+
+        // Pool transactions are never confirmed.
+        const auto slab = miss.first != slab_map::not_found ?
+            lookup_manager_.get(miss.first) :
+            (require_confirmed ? nullptr : pool_map_.find(point.hash()));
+
+        if (!slab)
+            continue;
+
+        auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(slab));
+
+        ///////////////////////////////////////////////////////////////////////
+        auto& mutex = metadata_mutex_.get(point.hash());
+        mutex.lock_shared();
+        const auto height = deserial.read_4_bytes_little_endian();
+        const auto position = deserial.read_2_bytes_little_endian();
+        const auto median_time_past = deserial.read_4_bytes_little_endian();
+        mutex.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        // The transaction does not exist at/below fork with matching state.
+        const auto confirmed = (position != unconfirmed);
+        if ((confirmed && height > fork_height) ||
+            (require_confirmed && !confirmed))
+            continue;
+
+        // Result is used only to parse the output.
+        transaction_result result(slab, point.hash(), 0, 0, 0, compress_);
+        prevout.cache = result.output(point.index());
+
+        if (!prevout.cache.is_valid())
+            continue;
+
+        prevout.height = height;
+        prevout.median_time_past = median_time_past;
+        prevout.coinbase = (position == 0);
+        ++populated;
+    }
+
+    return populated;
+}
+
+// Output cache.
+// ----------------------------------------------------------------------------
+
+bool transaction_database::save_cache(const path& filename,
+    const hash_digest& top) const
+{
+    return cache_.save(filename, top);
+}
+
+bool transaction_database::load_cache(const path& filename,
+    const hash_digest& top)
+{
+    const auto loaded = cache_.load(filename, top);
+
+    // A snapshot is valid only for the store state in which it was written.
+    boost::system::error_code ec;
+    boost::filesystem::remove(filename, ec);
+    return loaded;
+}
+
+// Outputs spent within the block are removed as they would be in push.
+void transaction_database::warm_cache(const block_result& block)
+{
+    if (cache_.disabled())
+        return;
+
+    for (const auto offset: block.transaction_offsets())
+    {
+        const auto result = get(offset);
+
+        if (!result)
+            continue;
+
+        const auto tx = result.transaction();
+
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs())
+                cache_.remove(input.previous_output());
+
+        cache_.add(tx, result.height(), result.median_time_past(), true);
+    }
+}
+
 file_offset transaction_database::store(const chain::transaction& tx,
     size_t height, uint32_t median_time_past, size_t position)
 {
     const auto hash = tx.hash();
 
-    // If is block tx previously identified as pooled then update the tx.
+    // If is block tx previously stored (pooled or demoted) then update the tx.
     // If confirm returns false the tx did not exist so create the tx.
-    // A false pooled flag saves the cost of predictable confirm failure.
-    if (position != unconfirmed && position != 0 && tx.validation.pooled)
+    // The unconfirmed index is in memory, so txs never pooled (as in initial
+    // block download) avoid the cost of predictable confirm failure, without
+    // relying on the pooled flag.
+    const auto indexed = position != unconfirmed && position != 0 &&
+        pool_index_.contains(hash);
+
+    if (indexed)
     {
         const auto offset = confirm(hash, height, median_time_past, position);
 
@@ -258,7 +665,7 @@ file_offset transaction_database::store(const chain::transaction& tx,
 
         // No terminate here as this is only a cache and there is no fail mode.
         // Instead this falls through and creates a new transaction.
-        BITCOIN_ASSERT_MSG(false, "pooled transaction not found");
+        BITCOIN_ASSERT_MSG(false, "indexed transaction not found");
     }
 
     BITCOIN_ASSERT(height <= max_uint32);
@@ -270,22 +677,38 @@ file_offset transaction_database::store(const chain::transaction& tx,
         serial.write_4_bytes_little_endian(static_cast<uint32_t>(height));
         serial.write_2_bytes_little_endian(static_cast<uint16_t>(position));
         serial.write_4_bytes_little_endian(median_time_past);
-        tx.to_data(serial, false);
+
+        if (compress_)
+            to_compressed_data(serial, tx);
+        else
+            tx.to_data(serial, false);
     };
 
-    const auto tx_size = tx.serialized_size(false);
+    const auto tx_size = compress_ ? compressed_size(tx) :
+        tx.serialized_size(false);
     BITCOIN_ASSERT(tx_size <= max_size_t - metadata_size);
     const auto total_size = metadata_size + static_cast<size_t>(tx_size);
 
-    const auto offset = lookup_map_.store(hash, write, total_size);
+    // Unconfirmed txs are written to the pool table, keeping the main dense.
+    const auto offset = position == unconfirmed ?
+        pool_map_.store(hash, write, total_size) :
+        lookup_map_.store(hash, write, total_size);
+
+    // A confirmed tx is never indexed.
+    if (position == unconfirmed)
+        index_pool(hash);
+    else if (indexed)
+        unindex_pool(hash);
+
     cache_.add(tx, height, median_time_past, position != unconfirmed);
 
     // We report this here because its a steady interval (block announce).
     if (!cache_.disabled() && position == 0)
     {
         LOG_DEBUG(LOG_DATABASE)
-            << "Output cache hit rate: " << cache_.hit_rate() << ", size: "
-            << cache_.size();
+            << "Output cache (" << to_string(cache_.policy()) << ") hit rate: "
+            << cache_.hit_rate() << ", size: " << cache_.size() << ", bytes: "
+            << cache_.usage();
     }
 
     return offset;
@@ -320,8 +743,19 @@ bool transaction_database::spend(const output_point& point,
     // Skip outputs until the target output.
     for (uint32_t output = 0; output < point.index(); ++output)
     {
-        serial.skip(spender_height_value_size);
-        serial.skip(serial.read_size_little_endian());
+        if (compress_)
+        {
+            serial.skip(height_size);
+            decompress_amount(serial);
+            serial.skip(script_payload_size(
+                serial.read_variable_little_endian()));
+        }
+        else
+        {
+            serial.skip(spender_height_value_size);
+            serial.skip(serial.read_size_little_endian());
+        }
+
         BITCOIN_ASSERT(serial);
     }
 
@@ -341,18 +775,138 @@ file_offset transaction_database::confirm(const hash_digest& hash,
     BITCOIN_ASSERT(height <= max_uint32);
     BITCOIN_ASSERT(position <= max_uint16);
 
+    // A coinbase cannot be pooled, so its demotion is not indexed.
+    const auto coinbase = position == unconfirmed && is_coinbase(hash);
+
     const auto update = [&](byte_serializer& serial)
     {
         ///////////////////////////////////////////////////////////////////////
         // Critical Section
-        unique_lock lock(metadata_mutex_);
+        unique_lock lock(metadata_mutex_.get(hash));
         serial.write_4_bytes_little_endian(static_cast<uint32_t>(height));
         serial.write_2_bytes_little_endian(static_cast<uint16_t>(position));
         serial.write_4_bytes_little_endian(median_time_past);
         ///////////////////////////////////////////////////////////////////////
     };
 
-    return lookup_map_.update(hash, update);
+    auto offset = lookup_map_.update(hash, update);
+
+    // A pool tx is moved to the confirmed table when confirmed.
+    if (offset == slab_map::not_found && position != unconfirmed)
+        offset = migrate(hash, height, median_time_past, position);
+
+    if (offset == slab_map::not_found)
+        return offset;
+
+    if (position != unconfirmed)
+        unindex_pool(hash);
+    else if (!coinbase)
+        index_pool(hash);
+
+    return offset;
+}
+
+// Rewrite the pool table with only the txs that remain pooled, reclaiming the
+// slabs of txs since migrated to the confirmed table. This is not thread safe.
+bool transaction_database::compact_pool()
+{
+    typedef std::pair<hash_digest, data_chunk> pooled;
+    std::vector<pooled> pool;
+
+    // The accessors are released before the pool table is rewritten.
+    for (const auto& hash: pool_index_.hashes())
+    {
+        const auto slab = pool_map_.find(hash);
+
+        // Demoted txs remain in the confirmed table.
+        if (slab == nullptr)
+            continue;
+
+        const transaction_result result(slab, hash, 0, 0, 0, compress_);
+        const auto start = REMAP_ADDRESS(slab);
+        pool.emplace_back(hash, data_chunk(start, start + metadata_size +
+            result.stored_size()));
+    }
+
+    if (!pool_header_.create())
+        return false;
+
+    pool_manager_.clear();
+
+    for (const auto& tx: pool)
+    {
+        const auto write = [&](byte_serializer& serial)
+        {
+            serial.write_bytes(tx.second);
+        };
+
+        pool_map_.store(tx.first, write, tx.second.size());
+    }
+
+    pool_manager_.sync();
+
+    LOG_DEBUG(LOG_DATABASE)
+        << "Compacted transaction pool: " << pool.size();
+    return true;
+}
+
+// private
+// True if the tx is stored as confirmed at position zero.
+bool transaction_database::is_coinbase(const hash_digest& hash) const
+{
+    const auto slab = lookup_map_.find(hash);
+
+    if (slab == nullptr)
+        return false;
+
+    auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(slab) +
+        height_size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(metadata_mutex_.get(hash));
+    return deserial.read_2_bytes_little_endian() == 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Copy the stored tx from the pool table to the main table, without parse.
+file_offset transaction_database::migrate(const hash_digest& hash,
+    size_t height, uint32_t median_time_past, size_t position)
+{
+    data_chunk data;
+
+    // The accessor is released before the main table is written, as the write
+    // may remap and the remap mutex is shared between the tables.
+    {
+        const auto slab = pool_map_.find(hash);
+
+        if (slab == nullptr)
+            return slab_map::not_found;
+
+        const transaction_result result(slab, hash, 0, 0, 0, compress_);
+        const auto tx_start = REMAP_ADDRESS(slab) + metadata_size;
+        data.assign(tx_start, tx_start + result.stored_size());
+    }
+
+    const auto write = [&](byte_serializer& serial)
+    {
+        serial.write_4_bytes_little_endian(static_cast<uint32_t>(height));
+        serial.write_2_bytes_little_endian(static_cast<uint16_t>(position));
+        serial.write_4_bytes_little_endian(median_time_past);
+        serial.write_bytes(data);
+    };
+
+    const auto offset = lookup_map_.store(hash, write,
+        metadata_size + data.size());
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(pool_mutex_);
+    pool_map_.unlink(hash);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return offset;
 }
 
 bool transaction_database::unconfirm(const hash_digest& hash)
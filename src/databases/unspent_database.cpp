@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/databases/unspent_database.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/memory/memory.hpp>
+
+// Record format (v4):
+// ----------------------------------------------------------------------------
+// [ height:4           - const ]
+// [ median_time_past:4 - const ]
+// [ coinbase:1         - const ]
+// [ value:8            - const ]
+// [ script:varint      - const ]
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::chain;
+
+static constexpr auto height_size = sizeof(uint32_t);
+static constexpr auto median_time_past_size = sizeof(uint32_t);
+static constexpr auto coinbase_size = sizeof(uint8_t);
+static constexpr auto metadata_size = height_size + median_time_past_size +
+    coinbase_size;
+
+// Unspent outputs use a hash table index, O(1).
+unspent_database::unspent_database(const path& filename, size_t buckets,
+    size_t expansion, mutex_ptr mutex)
+  : initial_map_file_size_(slab_hash_table_header_size(buckets) +
+        minimum_slabs_size),
+
+    lookup_file_(filename, mutex, expansion),
+    lookup_header_(lookup_file_, buckets),
+    lookup_manager_(lookup_file_, slab_hash_table_header_size(buckets)),
+    lookup_map_(lookup_header_, lookup_manager_)
+{
+}
+
+unspent_database::~unspent_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool unspent_database::create()
+{
+    // Resize and create require an opened file.
+    if (!lookup_file_.open())
+        return false;
+
+    // This will throw if insufficient disk space.
+    lookup_file_.resize(initial_map_file_size_);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool unspent_database::open()
+{
+    return
+        lookup_file_.open() &&
+        lookup_header_.start() &&
+        lookup_manager_.start();
+}
+
+bool unspent_database::close()
+{
+    return lookup_file_.close();
+}
+
+void unspent_database::synchronize()
+{
+    lookup_manager_.sync();
+}
+
+bool unspent_database::flush() const
+{
+    return lookup_file_.flush();
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+bool unspent_database::get(output& out_output, size_t& out_height,
+    uint32_t& out_median_time_past, bool& out_coinbase,
+    const output_point& point) const
+{
+    const auto slab = lookup_map_.find(point);
+
+    if (!slab)
+        return false;
+
+    auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(slab));
+    out_height = deserial.read_4_bytes_little_endian();
+    out_median_time_past = deserial.read_4_bytes_little_endian();
+    out_coinbase = deserial.read_byte() != 0;
+    out_output = output::factory(deserial, true);
+    return true;
+}
+
+// Store.
+// ----------------------------------------------------------------------------
+
+void unspent_database::store(const transaction& tx, size_t height,
+    uint32_t median_time_past)
+{
+    const auto hash = tx.hash();
+    const auto coinbase = tx.is_coinbase();
+    const auto& outputs = tx.outputs();
+
+    for (uint32_t index = 0; index < outputs.size(); ++index)
+    {
+        const auto& output = outputs[index];
+
+        // Provably unspendable outputs never enter the working set.
+        if (output.script().is_unspendable())
+            continue;
+
+        store({ hash, index }, output, height, median_time_past, coinbase);
+    }
+}
+
+void unspent_database::store(const output_point& point, const output& output,
+    size_t height, uint32_t median_time_past, bool coinbase)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto height32 = static_cast<uint32_t>(height);
+
+    const auto write = [&](byte_serializer& serial)
+    {
+        serial.write_4_bytes_little_endian(height32);
+        serial.write_4_bytes_little_endian(median_time_past);
+        serial.write_byte(coinbase ? 1 : 0);
+        output.to_data(serial, true);
+    };
+
+    const auto output_size = output.serialized_size(true);
+    BITCOIN_ASSERT(output_size <= max_size_t - metadata_size);
+    const auto total_size = metadata_size + static_cast<size_t>(output_size);
+
+    lookup_map_.store(point, write, total_size);
+}
+
+// Unlink is not safe for concurrent write.
+bool unspent_database::unlink(const output_point& point)
+{
+    auto memory = lookup_map_.find(point);
+
+    // The output may be absent (e.g. parallel insert has created a gap).
+    if (memory == nullptr)
+        return false;
+
+    // Release lock before unlinking.
+    memory = nullptr;
+    return lookup_map_.unlink(point);
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/gap_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+size_t gap_index::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return ranges_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t gap_index::count() const
+{
+    size_t total = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (const auto& gap: ranges_)
+        total += gap.second - gap.first;
+
+    return total;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void gap_index::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    ranges_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void gap_index::insert(size_t first, size_t count)
+{
+    if (count == 0)
+        return;
+
+    auto end = ceiling_add(first, count);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Start from the preceding range if it overlaps or abuts.
+    auto it = ranges_.upper_bound(first);
+
+    if (it != ranges_.begin() && std::prev(it)->second >= first)
+        --it;
+
+    // Absorb all ranges that overlap or abut [first, end).
+    while (it != ranges_.end() && it->first <= end)
+    {
+        first = std::min(first, it->first);
+        end = std::max(end, it->second);
+        it = ranges_.erase(it);
+    }
+
+    ranges_.emplace(first, end);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void gap_index::erase(size_t first, size_t count)
+{
+    if (count == 0)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    remove(first, ceiling_add(first, count));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void gap_index::truncate(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    remove(height, max_size_t);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t gap_index::next(size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    auto it = ranges_.upper_bound(height);
+
+    // Ranges are disjoint and not abutting, so the end is never missing.
+    if (it != ranges_.begin() && (--it)->second > height)
+        return it->second;
+
+    return height;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+gap_index::ranges gap_index::get() const
+{
+    ranges out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    out.reserve(ranges_.size());
+
+    for (const auto& gap: ranges_)
+        out.push_back({ gap.first, gap.second - gap.first });
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void gap_index::get(heights& out_heights) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (const auto& gap: ranges_)
+        for (auto height = gap.first; height < gap.second; ++height)
+            out_heights.push_back(height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void gap_index::remove(size_t first, size_t end)
+{
+    // Start from the preceding range if it overlaps.
+    auto it = ranges_.upper_bound(first);
+
+    if (it != ranges_.begin() && std::prev(it)->second > first)
+        --it;
+
+    range_map remainders;
+
+    // Remove overlapping ranges, retaining any portions outside [first, end).
+    while (it != ranges_.end() && it->first < end)
+    {
+        if (it->first < first)
+            remainders.emplace(it->first, first);
+
+        if (it->second > end)
+            remainders.emplace(end, it->second);
+
+        it = ranges_.erase(it);
+    }
+
+    ranges_.insert(remainders.begin(), remainders.end());
+}
+
+} // namespace database
+} // namespace libbitcoin
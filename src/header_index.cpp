@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/header_index.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::chain;
+
+size_t header_index::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::assign(list&& entries)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    entries_ = std::move(entries);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Value initialization of new entries produces null hashes.
+void header_index::set(size_t height, const entry& value)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (height >= entries_.size())
+        entries_.resize(height + 1);
+
+    entries_[height] = value;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::truncate(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (height < entries_.size())
+        entries_.resize(height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get(entry& out_entry, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= entries_.size() || entries_[height].hash == null_hash)
+        return false;
+
+    out_entry = entries_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get(hash_digest& out_hash, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= entries_.size() || entries_[height].hash == null_hash)
+        return false;
+
+    out_hash = entries_[height].hash;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// static
+header header_index::to_header(const entry& value)
+{
+    return header::factory(to_chunk(value.header), true);
+}
+
+} // namespace database
+} // namespace libbitcoin
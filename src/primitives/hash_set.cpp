@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/primitives/hash_set.hpp>
+
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/memory/memory_map.hpp>
+#include <bitcoin/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+static constexpr auto header_size = 0u;
+
+hash_set::hash_set(memory_map& file)
+  : manager_(file, header_size, hash_size)
+{
+}
+
+bool hash_set::create()
+{
+    return manager_.create();
+}
+
+bool hash_set::start()
+{
+    if (!manager_.start())
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    const auto count = manager_.count();
+    positions_.clear();
+    positions_.reserve(count);
+
+    for (array_index index = 0; index < count; ++index)
+        positions_.emplace(read(index), index);
+
+    return positions_.size() == count;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void hash_set::sync()
+{
+    manager_.sync();
+}
+
+size_t hash_set::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return positions_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool hash_set::contains(const hash_digest& hash) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return positions_.find(hash) != positions_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool hash_set::insert(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (positions_.find(hash) != positions_.end())
+        return false;
+
+    const auto index = manager_.new_records(1);
+    write(index, hash);
+    positions_.emplace(hash, index);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Move the last hash into the vacated record and truncate.
+bool hash_set::remove(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    const auto it = positions_.find(hash);
+
+    if (it == positions_.end())
+        return false;
+
+    const auto index = it->second;
+    const auto last = manager_.count() - 1;
+    positions_.erase(it);
+
+    if (index != last)
+    {
+        const auto moved = read(last);
+        write(index, moved);
+        positions_[moved] = index;
+    }
+
+    manager_.set_count(last);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+hash_list hash_set::hashes() const
+{
+    hash_list out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto count = manager_.count();
+    out.reserve(count);
+
+    for (array_index index = 0; index < count; ++index)
+        out.push_back(read(index));
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+hash_digest hash_set::read(array_index index) const
+{
+    const auto record = manager_.get(index);
+    auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(record));
+    return deserial.read_hash();
+}
+
+void hash_set::write(array_index index, const hash_digest& hash)
+{
+    const auto record = manager_.get(index);
+    auto serial = make_unsafe_serializer(REMAP_ADDRESS(record));
+    serial.write_hash(hash);
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/primitives/record_cluster_iterator.hpp>
+
+#include <bitcoin/database/define.hpp>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/primitives/record_list.hpp>
+#include <bitcoin/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+record_cluster_iterator::record_cluster_iterator(
+    const record_manager& manager, array_index cluster, array_index rows)
+  : index_(cluster == record_list::empty || rows == 0 ? record_list::empty :
+        cluster + rows),
+    cluster_(cluster),
+    manager_(manager)
+{
+}
+
+void record_cluster_iterator::operator++()
+{
+    // Rows follow the cluster header, so step down until the header.
+    if (index_ > cluster_ + 1)
+    {
+        --index_;
+        return;
+    }
+
+    const auto memory = manager_.get(cluster_);
+    auto deserial = make_unsafe_deserializer(REMAP_ADDRESS(memory));
+    const auto next = deserial.read_4_bytes_little_endian();
+    const auto rows = deserial.read_4_bytes_little_endian();
+
+    // The next cluster is older and therefore full.
+    cluster_ = next;
+    index_ = next == record_list::empty ? record_list::empty : next + rows;
+}
+
+array_index record_cluster_iterator::operator*() const
+{
+    return index_;
+}
+
+bool record_cluster_iterator::operator==(record_cluster_iterator other) const
+{
+    return this->index_ == other.index_;
+}
+
+bool record_cluster_iterator::operator!=(record_cluster_iterator other) const
+{
+    return this->index_ != other.index_;
+}
+
+} // namespace database
+} // namespace libbitcoin
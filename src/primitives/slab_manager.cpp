@@ -83,6 +83,18 @@ bool slab_manager::start()
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void slab_manager::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    payload_size_ = sizeof(file_offset);
+    file_.resize(header_size_ + payload_size_);
+    write_size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 void slab_manager::sync() const
 {
     // Critical Section
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/primitives/striped_mutex.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+// Keys are hashes, so any eight bytes are uniformly distributed.
+const size_t striped_mutex::default_stripes = 256;
+
+striped_mutex::striped_mutex(size_t stripes)
+  : mutexes_(stripes)
+{
+    BITCOIN_ASSERT(stripes != 0);
+}
+
+size_t striped_mutex::size() const
+{
+    return mutexes_.size();
+}
+
+shared_mutex& striped_mutex::get(const hash_digest& key) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(key.begin());
+    return mutexes_[value % mutexes_.size()];
+}
+
+shared_mutex& striped_mutex::get(const short_hash& key) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(key.begin());
+    return mutexes_[value % mutexes_.size()];
+}
+
+// Stripes are always acquired in order, so concurrent calls cannot deadlock.
+void striped_mutex::lock() const
+{
+    for (auto& mutex: mutexes_)
+        mutex.lock();
+}
+
+void striped_mutex::unlock() const
+{
+    for (auto mutex = mutexes_.rbegin(); mutex != mutexes_.rend(); ++mutex)
+        mutex->unlock();
+}
+
+} // namespace database
+} // namespace libbitcoin
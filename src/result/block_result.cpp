@@ -24,6 +24,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 #include <bitcoin/database/primitives/record_manager.hpp>
+#include <bitcoin/database/result/offset_iterable.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -34,10 +35,14 @@ static constexpr size_t version_size = sizeof(uint32_t);
 static constexpr size_t previous_size = hash_size;
 static constexpr size_t merkle_size = hash_size;
 static constexpr size_t time_size = sizeof(uint32_t);
+static constexpr size_t bits_size = sizeof(uint32_t);
+static constexpr size_t nonce_size = sizeof(uint32_t);
 
 static constexpr auto version_offset = 0u;
 static constexpr auto time_offset = version_size + previous_size + merkle_size;
 static constexpr auto bits_offset = time_offset + time_size;
+static constexpr auto median_time_past_offset = bits_offset + bits_size +
+    nonce_size;
 
 block_result::block_result(const record_manager& index_manager)
   : record_(nullptr),
@@ -118,6 +123,14 @@ uint32_t block_result::bits() const
     return from_little_endian_unsafe<uint32_t>(memory + bits_offset);
 }
 
+uint32_t block_result::median_time_past() const
+{
+    BITCOIN_ASSERT(record_);
+    const auto memory = REMAP_ADDRESS(record_);
+    return from_little_endian_unsafe<uint32_t>(memory +
+        median_time_past_offset);
+}
+
 uint32_t block_result::timestamp() const
 {
     BITCOIN_ASSERT(record_);
@@ -142,7 +155,52 @@ size_t block_result::transaction_count() const
     return tx_count_;
 }
 
-offset_list block_result::transaction_offsets() const
+bool block_result::compact() const
+{
+    if (tx_count_ == 0 || tx_start_ >= index_manager_.count())
+        return false;
+
+    const auto record = index_manager_.get(tx_start_);
+    const auto slot = from_little_endian_unsafe<uint64_t>(
+        REMAP_ADDRESS(record));
+    return (slot & short_id_tag) != 0;
+}
+
+// Offsets are contiguous in the tx index, so they are read in place.
+offset_iterable block_result::transaction_offsets() const
+{
+    if (tx_count_ == 0 || tx_start_ + tx_count_ > index_manager_.count())
+        return{};
+
+    const auto records = index_manager_.get(tx_start_);
+
+    if (!records)
+        return{};
+
+    const auto slot = from_little_endian_unsafe<uint64_t>(
+        REMAP_ADDRESS(records));
+
+    if ((slot & short_id_tag) != 0)
+        return{};
+
+    return{ records, tx_count_ };
+}
+
+short_id_list block_result::short_ids() const
+{
+    auto slots = read_slots();
+
+    if (slots.empty() || (slots.front() & short_id_tag) == 0)
+        return{};
+
+    for (auto& slot: slots)
+        slot &= ~short_id_tag;
+
+    return slots;
+}
+
+// All slots of a block are either tx offsets or tagged short ids.
+offset_list block_result::read_slots() const
 {
     const auto end = tx_start_ + tx_count_;
     if (end > index_manager_.count())
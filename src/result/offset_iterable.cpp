@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/offset_iterable.hpp>
+
+#include <cstddef>
+#include <bitcoin/database/memory/memory.hpp>
+#include <bitcoin/database/result/offset_iterator.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+offset_iterable::offset_iterable()
+  : memory_(nullptr), count_(0)
+{
+}
+
+offset_iterable::offset_iterable(memory_ptr memory, size_t count)
+  : memory_(memory), count_(memory ? count : 0)
+{
+}
+
+size_t offset_iterable::size() const
+{
+    return count_;
+}
+
+bool offset_iterable::empty() const
+{
+    return count_ == 0;
+}
+
+offset_iterator offset_iterable::begin() const
+{
+    return{ memory_ ? REMAP_ADDRESS(memory_) : nullptr };
+}
+
+offset_iterator offset_iterable::end() const
+{
+    return{ memory_ ? REMAP_ADDRESS(memory_) + count_ * sizeof(file_offset) :
+        nullptr };
+}
+
+} // namespace database
+} // namespace libbitcoin
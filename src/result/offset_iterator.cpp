@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/result/offset_iterator.hpp>
+
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+offset_iterator::offset_iterator(const uint8_t* position)
+  : position_(position)
+{
+}
+
+void offset_iterator::operator++()
+{
+    position_ += sizeof(file_offset);
+}
+
+file_offset offset_iterator::operator*() const
+{
+    return from_little_endian_unsafe<file_offset>(position_);
+}
+
+bool offset_iterator::operator==(offset_iterator other) const
+{
+    return this->position_ == other.position_;
+}
+
+bool offset_iterator::operator!=(offset_iterator other) const
+{
+    return this->position_ != other.position_;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <utility>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/database/compression.hpp>
 #include <bitcoin/database/databases/transaction_database.hpp>
 #include <bitcoin/database/memory/memory.hpp>
 
@@ -32,11 +33,55 @@ using namespace bc::chain;
 
 static constexpr auto value_size = sizeof(uint64_t);
 static constexpr auto height_size = sizeof(uint32_t);
+static constexpr auto index_size = sizeof(uint16_t);
+static constexpr auto sequence_size = sizeof(uint32_t);
 static constexpr auto position_size = sizeof(uint16_t);
 static constexpr auto median_time_past_size = sizeof(uint32_t);
 static constexpr auto metadata_size = height_size + position_size +
     median_time_past_size;
 
+// Read a variable length integer and advance the position past it.
+static uint64_t read_variable(uint8_t*& position)
+{
+    auto deserial = make_unsafe_deserializer(position);
+    const auto value = deserial.read_variable_little_endian();
+    position += variable_uint_size(value);
+    return value;
+}
+
+// Read a compressed amount and advance the position past it.
+static uint64_t read_amount(uint8_t*& position)
+{
+    auto deserial = make_unsafe_deserializer(position);
+    const auto value = decompress_amount(deserial);
+    position += compressed_amount_size(value);
+    return value;
+}
+
+// Advance the position past a stored output [height:4][value][script].
+static void skip_output(uint8_t*& position, bool compressed)
+{
+    position += height_size;
+
+    if (compressed)
+    {
+        read_amount(position);
+        position += script_payload_size(read_variable(position));
+        return;
+    }
+
+    position += value_size;
+    position += read_variable(position);
+}
+
+// Advance the position past a stored input [hash:32][index:2][script][seq:4].
+static void skip_input(uint8_t*& position)
+{
+    position += hash_size + index_size;
+    position += read_variable(position);
+    position += sequence_size;
+}
+
 transaction_result::transaction_result()
   : transaction_result(nullptr)
 {
@@ -47,27 +92,31 @@ transaction_result::transaction_result(memory_ptr slab)
     height_(0),
     median_time_past_(0),
     position_(0),
+    compressed_(false),
     hash_(null_hash)
 {
 }
 
 transaction_result::transaction_result(memory_ptr slab, hash_digest&& hash,
-    uint32_t height, uint32_t median_time_past, uint16_t position)
+    uint32_t height, uint32_t median_time_past, uint16_t position,
+    bool compressed)
   : slab_(slab),
     height_(height),
     median_time_past_(median_time_past),
     position_(position),
+    compressed_(compressed),
     hash_(std::move(hash))
 {
 }
 
 transaction_result::transaction_result(memory_ptr slab,
     const hash_digest& hash, uint32_t height, uint32_t median_time_past,
-    uint16_t position)
+    uint16_t position, bool compressed)
   : slab_(slab),
     height_(height),
     median_time_past_(median_time_past),
     position_(position),
+    compressed_(compressed),
     hash_(hash)
 {
 }
@@ -117,62 +166,311 @@ bool transaction_result::is_spent(size_t fork_height) const
         return false;
 
     BITCOIN_ASSERT(slab_);
-    const auto tx_start = REMAP_ADDRESS(slab_) + metadata_size;
-    auto deserial = make_unsafe_deserializer(tx_start);
-    const auto outputs = deserial.read_size_little_endian();
-    BITCOIN_ASSERT(deserial);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto outputs = read_variable(position);
 
     // Search all outputs for an unspent indication.
-    for (uint32_t output = 0; output < outputs; ++output)
+    for (uint64_t output = 0; output < outputs; ++output)
     {
-        const auto spender_height = deserial.read_4_bytes_little_endian();
-        BITCOIN_ASSERT(deserial);
+        const auto spender_height = from_little_endian_unsafe<uint32_t>(
+            position);
 
         // A spend from above the fork height is not an actual spend.
         if (spender_height == output::validation::not_spent ||
             spender_height > fork_height)
             return false;
 
-        deserial.skip(value_size);
-        deserial.skip(deserial.read_size_little_endian());
-        BITCOIN_ASSERT(deserial);
+        skip_output(position, compressed_);
     }
 
     return true;
 }
 
-// Spentness is unguarded and will be inconsistent during write.
-// If index is out of range returns default/invalid output (.value not_found).
-chain::output transaction_result::output(uint32_t index) const
+size_t transaction_result::input_count() const
 {
     BITCOIN_ASSERT(slab_);
-    const auto tx_start = REMAP_ADDRESS(slab_) + metadata_size;
-    auto deserial = make_unsafe_deserializer(tx_start);
-    const auto outputs = deserial.read_size_little_endian();
-    BITCOIN_ASSERT(deserial);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto outputs = read_variable(position);
 
-    if (index >= outputs)
+    // Skip all outputs to reach the input count.
+    for (uint64_t output = 0; output < outputs; ++output)
+        skip_output(position, compressed_);
+
+    return static_cast<size_t>(read_variable(position));
+}
+
+size_t transaction_result::output_count() const
+{
+    BITCOIN_ASSERT(slab_);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    return static_cast<size_t>(read_variable(position));
+}
+
+// If index is out of range returns output::not_found.
+uint64_t transaction_result::output_value(uint32_t index) const
+{
+    auto position = find_output(index);
+
+    if (position == nullptr)
+        return chain::output::not_found;
+
+    position += height_size;
+
+    return compressed_ ? read_amount(position) :
+        from_little_endian_unsafe<uint64_t>(position);
+}
+
+bool transaction_result::compressed() const
+{
+    return compressed_;
+}
+
+// If index is out of range or outputs are compressed returns an empty slice.
+data_slice transaction_result::output_script(uint32_t index) const
+{
+    auto position = compressed_ ? nullptr : find_output(index);
+
+    if (position == nullptr)
+        return{};
+
+    position += height_size + value_size;
+    const auto size = read_variable(position);
+    return{ position, position + size };
+}
+
+// If index is out of range returns an empty script.
+data_chunk transaction_result::output_script_data(uint32_t index) const
+{
+    if (!compressed_)
+        return to_chunk(output_script(index));
+
+    auto position = find_output(index);
+
+    if (position == nullptr)
         return{};
 
+    position += height_size;
+    read_amount(position);
+    const auto code = read_variable(position);
+    return decompress_script(code, position);
+}
+
+// Returns the address of the indexed output's spender height, or nullptr.
+uint8_t* transaction_result::find_output(uint32_t index) const
+{
+    BITCOIN_ASSERT(slab_);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto outputs = read_variable(position);
+
+    if (index >= outputs)
+        return nullptr;
+
     // Skip outputs until the target output.
     for (uint32_t output = 0; output < index; ++output)
+        skip_output(position, compressed_);
+
+    return position;
+}
+
+// Spentness is unguarded and will be inconsistent during write.
+// If index is out of range returns default/invalid output (.value not_found).
+chain::output transaction_result::output(uint32_t index) const
+{
+    auto position = find_output(index);
+
+    if (position == nullptr)
+        return{};
+
+    if (!compressed_)
     {
-        deserial.skip(height_size + value_size);
-        deserial.skip(deserial.read_size_little_endian());
-        BITCOIN_ASSERT(deserial);
+        // Read and return the target output (including spender height).
+        auto deserial = make_unsafe_deserializer(position);
+        return chain::output::factory(deserial, false);
     }
 
-    // Read and return the target output (including spender height).
-    return chain::output::factory(deserial, false);
+    const auto spender_height = from_little_endian_unsafe<uint32_t>(position);
+    position += height_size;
+    const auto value = read_amount(position);
+    const auto code = read_variable(position);
+
+    chain::output out(value, { decompress_script(code, position), false });
+    out.validation.spender_height = spender_height;
+    return out;
 }
 
 // Spentness is unguarded and will be inconsistent during write.
 chain::transaction transaction_result::transaction() const
 {
     BITCOIN_ASSERT(slab_);
-    const auto tx_start = REMAP_ADDRESS(slab_) + metadata_size;
-    auto deserial = make_unsafe_deserializer(tx_start);
-    return transaction::factory(deserial, hash_);
+
+    if (!compressed_)
+    {
+        const auto tx_start = REMAP_ADDRESS(slab_) + metadata_size;
+        auto deserial = make_unsafe_deserializer(tx_start);
+        return transaction::factory(deserial, hash_);
+    }
+
+    // Decompress to wire form and restore spender heights from the slab.
+    data_chunk data(serialized_size());
+    auto serial = make_unsafe_serializer(data.begin());
+    to_data(serial);
+
+    auto deserial = make_unsafe_deserializer(data.begin());
+    auto tx = transaction::factory(deserial, true);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    read_variable(position);
+
+    for (auto& output: tx.outputs())
+    {
+        output.validation.spender_height =
+            from_little_endian_unsafe<uint32_t>(position);
+        skip_output(position, compressed_);
+    }
+
+    return tx;
+}
+
+// The stored (non-wire) form places outputs first, prefixes each output with
+// its spender height, shortens point indexes and varint-encodes locktime and
+// version. Wire size is derived from the stored form without parsing scripts.
+size_t transaction_result::serialized_size() const
+{
+    BITCOIN_ASSERT(slab_);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto outputs = read_variable(position);
+    size_t size = variable_uint_size(outputs);
+
+    for (uint64_t output = 0; output < outputs; ++output)
+    {
+        position += height_size;
+        size_t script;
+
+        if (compressed_)
+        {
+            read_amount(position);
+            const auto code = read_variable(position);
+            position += script_payload_size(code);
+            script = script_size(code);
+        }
+        else
+        {
+            position += value_size;
+            script = static_cast<size_t>(read_variable(position));
+            position += script;
+        }
+
+        size += value_size + variable_uint_size(script) + script;
+    }
+
+    const auto inputs_start = position;
+    const auto inputs = read_variable(position);
+
+    for (uint64_t input = 0; input < inputs; ++input)
+        skip_input(position);
+
+    // Inputs differ from wire only in point index width.
+    size += static_cast<size_t>(position - inputs_start);
+    size += inputs * (sizeof(uint32_t) - index_size);
+
+    // Locktime and version.
+    return size + 2 * sizeof(uint32_t);
+}
+
+size_t transaction_result::stored_size() const
+{
+    BITCOIN_ASSERT(slab_);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto start = position;
+    const auto outputs = read_variable(position);
+
+    for (uint64_t output = 0; output < outputs; ++output)
+        skip_output(position, compressed_);
+
+    const auto inputs = read_variable(position);
+
+    for (uint64_t input = 0; input < inputs; ++input)
+        skip_input(position);
+
+    // Locktime and version.
+    read_variable(position);
+    read_variable(position);
+    return static_cast<size_t>(position - start);
+}
+
+// Spender heights are skipped, so this is safe during concurrent spend.
+void transaction_result::to_data(writer& sink) const
+{
+    BITCOIN_ASSERT(slab_);
+    auto position = REMAP_ADDRESS(slab_) + metadata_size;
+    const auto outputs = read_variable(position);
+    const auto outputs_start = position;
+
+    for (uint64_t output = 0; output < outputs; ++output)
+        skip_output(position, compressed_);
+
+    const auto inputs = read_variable(position);
+    const auto inputs_start = position;
+
+    for (uint64_t input = 0; input < inputs; ++input)
+        skip_input(position);
+
+    const auto locktime = read_variable(position);
+    const auto version = read_variable(position);
+
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(version));
+    sink.write_variable_little_endian(inputs);
+    position = inputs_start;
+
+    for (uint64_t input = 0; input < inputs; ++input)
+    {
+        sink.write_bytes(position, hash_size);
+        position += hash_size;
+
+        // The stored index is shortened, with max_uint16 as the null index.
+        const auto index = from_little_endian_unsafe<uint16_t>(position);
+        position += index_size;
+        sink.write_4_bytes_little_endian(index == max_uint16 ?
+            point::null_index : index);
+
+        const auto size = read_variable(position);
+        sink.write_variable_little_endian(size);
+        sink.write_bytes(position, size);
+        position += size;
+
+        sink.write_bytes(position, sequence_size);
+        position += sequence_size;
+    }
+
+    sink.write_variable_little_endian(outputs);
+    position = outputs_start;
+
+    for (uint64_t output = 0; output < outputs; ++output)
+    {
+        // Skip the spender height.
+        position += height_size;
+
+        if (compressed_)
+        {
+            const auto value = read_amount(position);
+            sink.write_8_bytes_little_endian(value);
+
+            const auto code = read_variable(position);
+            sink.write_variable_little_endian(script_size(code));
+            decompress_script(sink, code, position);
+            position += script_payload_size(code);
+            continue;
+        }
+
+        sink.write_bytes(position, value_size);
+        position += value_size;
+
+        const auto size = read_variable(position);
+        sink.write_variable_little_endian(size);
+        sink.write_bytes(position, size);
+        position += size;
+    }
+
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(locktime));
 }
 
 } // namespace database
@@ -35,9 +35,16 @@ settings::settings()
     // Hash table sizes (must be configured).
     block_table_buckets(0),
     transaction_table_buckets(0),
+    transaction_pool_table_buckets(0),
+    unspent_table_buckets(0),
     spend_table_buckets(0),
     history_table_buckets(0),
-    cache_capacity(0)
+    cache_bytes(0),
+    cache_policy(eviction_policy::fifo),
+    cache_warm_blocks(0),
+    cache_headers(false),
+    block_cache_capacity(0),
+    compress_outputs(false)
 {
 }
 
@@ -50,6 +57,8 @@ settings::settings(config::settings context)
         {
             block_table_buckets = 650000;
             transaction_table_buckets = 110000000;
+            transaction_pool_table_buckets = 1000000;
+            unspent_table_buckets = 70000000;
             spend_table_buckets = 250000000;
             history_table_buckets = 107000000;
             break;
@@ -60,6 +69,8 @@ settings::settings(config::settings context)
             // TODO: optimize for testnet.
             block_table_buckets = 650000;
             transaction_table_buckets = 110000000;
+            transaction_pool_table_buckets = 1000000;
+            unspent_table_buckets = 70000000;
             spend_table_buckets = 250000000;
             history_table_buckets = 107000000;
             break;
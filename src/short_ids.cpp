@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/database/short_ids.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+static constexpr uint64_t short_id_mask = 0x0000ffffffffffff;
+
+// Single sha256 of the wire header and little endian nonce (bip152).
+siphash_key short_id_key(const message::compact_block& compact)
+{
+    const auto hash = sha256_hash(build_chunk(
+    {
+        compact.header().to_data(),
+        to_little_endian(compact.nonce())
+    }));
+
+    half_hash key;
+    std::copy_n(hash.begin(), key.size(), key.begin());
+    return to_siphash_key(key);
+}
+
+uint64_t to_short_id(const siphash_key& key, const hash_digest& hash)
+{
+    return siphash(key, hash) & short_id_mask;
+}
+
+uint64_t to_short_id(const message::compact_block::short_id& id)
+{
+    uint64_t value = 0;
+
+    for (size_t byte = 0; byte < id.size(); ++byte)
+        value |= static_cast<uint64_t>(id[byte]) << (byte * 8);
+
+    return value;
+}
+
+} // namespace database
+} // namespace libbitcoin
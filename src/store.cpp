@@ -34,7 +34,12 @@ using namespace bc::database;
 #define BLOCK_INDEX "block_index"
 #define BLOCK_TABLE "block_table"
 #define TRANSACTION_INDEX "transaction_index"
+#define TRANSACTION_POOL_INDEX "transaction_pool_index"
+#define TRANSACTION_POOL_TABLE "transaction_pool_table"
 #define TRANSACTION_TABLE "transaction_table"
+#define TRANSACTION_FORMAT "transaction_format"
+#define UNSPENT_TABLE "unspent_table"
+#define OUTPUT_CACHE "output_cache"
 #define SPEND_TABLE "spend_table"
 #define HISTORY_TABLE "history_table"
 #define HISTORY_ROWS "history_rows"
@@ -70,7 +75,12 @@ store::store(const path& prefix, bool with_indexes, bool flush_each_write)
     block_index(prefix / BLOCK_INDEX),
     block_table(prefix / BLOCK_TABLE),
     transaction_index(prefix / TRANSACTION_INDEX),
+    transaction_pool_index(prefix / TRANSACTION_POOL_INDEX),
+    transaction_pool_table(prefix / TRANSACTION_POOL_TABLE),
     transaction_table(prefix / TRANSACTION_TABLE),
+    transaction_format(prefix / TRANSACTION_FORMAT),
+    unspent_table(prefix / UNSPENT_TABLE),
+    output_cache(prefix / OUTPUT_CACHE),
 
     // Optional indexes.
     history_rows(prefix / HISTORY_ROWS),
@@ -90,7 +100,10 @@ bool store::create()
         create(block_table) &&
         create(block_index) &&
         create(transaction_table) &&
-        create(transaction_index);
+        create(transaction_index) &&
+        create(transaction_pool_table) &&
+        create(transaction_pool_index) &&
+        create(unspent_table);
 
     if (!use_indexes)
         return created;
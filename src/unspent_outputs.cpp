@@ -18,7 +18,14 @@
  */
 #include <bitcoin/database/unspent_outputs.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 
 namespace libbitcoin {
@@ -26,10 +33,285 @@ namespace database {
 
 using namespace bc::chain;
 
+static const uint32_t none = max_uint32;
+
+// Snapshot format:
+// ----------------------------------------------------------------------------
+// [ version:4 ][ tag:32 ][ shards:4 ]
+// For each shard: [ count:4 ] and for each output, oldest first:
+// [ hash:32 ][ index:4 ][ height:4 ][ median_time_past:4 ][ flags:1 ]
+// [ value:8 ][ script:varint ]
+static const uint32_t snapshot_version = 1;
+static const uint8_t coinbase_flag = 1;
+static const uint8_t confirmed_flag = 2;
+
+// Shards are only introduced where each retains a useful age window.
+const size_t unspent_outputs::maximum_shards = 64;
+const size_t unspent_outputs::minimum_shard_capacity = 1024 * 1024;
+const size_t unspent_outputs::inline_script_size = script_capacity;
+
+// The pooled entry, its free list slot and its (at most half full) buckets.
+const size_t unspent_outputs::output_overhead = sizeof(entry) +
+    sizeof(slot) + 2 * sizeof(slot);
+
+std::string to_string(eviction_policy policy)
+{
+    switch (policy)
+    {
+        case eviction_policy::clock:
+            return "clock";
+        case eviction_policy::selective:
+            return "selective";
+        case eviction_policy::fifo:
+        default:
+            return "fifo";
+    }
+}
+
+unspent_outputs::shard::shard()
+  : capacity(0), hits(0), queries(0), usage(0), oldest(none), newest(none)
+{
+}
+
 // Because of BIP30 it is safe to use tx hashes as identifiers here.
-unspent_outputs::unspent_outputs(size_t capacity)
-  : capacity_(capacity), hits_(1), queries_(1), sequence_(0)
+unspent_outputs::unspent_outputs(size_t capacity, eviction_policy policy)
+  : capacity_(capacity), policy_(policy), shards_(shard_count(capacity))
+{
+    const auto count = shards_.size();
+
+    // Distribute the capacity so that the shards sum to the total.
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto& shard = shards_[index];
+        shard.capacity = capacity / count + (index < capacity % count ? 1 : 0);
+
+        // Reserve the pool so that the budget is not exceeded by growth.
+        const auto outputs = shard.capacity / output_overhead;
+        shard.pool.reserve(outputs);
+        shard.table.assign(table_size(outputs), none);
+
+        // The pool never exceeds this size, so the flags are never resized.
+        if (policy != eviction_policy::fifo)
+            shard.referenced = std::vector<std::atomic<bool>>(outputs);
+    }
+}
+
+size_t unspent_outputs::shard_count(size_t capacity)
+{
+    const auto count = capacity / minimum_shard_capacity;
+    return std::max(size_t(1), std::min(count, maximum_shards));
+}
+
+// The smallest power of two that holds the outputs at half load.
+size_t unspent_outputs::table_size(size_t outputs)
+{
+    if (outputs == 0)
+        return 0;
+
+    size_t size = 1;
+
+    while (size < 2 * outputs)
+        size <<= 1;
+
+    return size;
+}
+
+size_t unspent_outputs::footprint(const entry& entry)
+{
+    return output_overhead + entry.oversized_script.size();
+}
+
+// Small scripts are held inline, avoiding an allocation.
+void unspent_outputs::set_script(entry& entry, data_chunk&& script)
+{
+    entry.script_size = 0;
+
+    if (script.size() > script_capacity)
+    {
+        entry.oversized_script = std::move(script);
+        return;
+    }
+
+    entry.script_size = static_cast<uint8_t>(script.size());
+    std::copy(script.begin(), script.end(), entry.script.begin());
+}
+
+data_chunk unspent_outputs::get_script(const entry& entry)
+{
+    if (!entry.oversized_script.empty())
+        return entry.oversized_script;
+
+    return{ entry.script.begin(), entry.script.begin() + entry.script_size };
+}
+
+// Keys are hashes, so any eight bytes are uniformly distributed.
+unspent_outputs::shard& unspent_outputs::get_shard(
+    const hash_digest& tx_hash) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(tx_hash.begin());
+    return shards_[value % shards_.size()];
+}
+
+// Shards are selected by the first eight bytes of the tx hash, so buckets use
+// the next eight, mixed with the index to separate outputs of a tx.
+size_t unspent_outputs::bucket(const shard& shard, const point& point)
 {
+    const auto value = from_little_endian_unsafe<uint64_t>(
+        point.hash().begin() + sizeof(uint64_t));
+    const auto mixed = value ^ (point.index() * 0x9e3779b97f4a7c15);
+    return static_cast<size_t>(mixed) & (shard.table.size() - 1);
+}
+
+// Linear probe terminates as the table is never more than half full.
+unspent_outputs::slot unspent_outputs::find(const shard& shard,
+    const point& point)
+{
+    if (shard.table.empty())
+        return none;
+
+    const auto mask = shard.table.size() - 1;
+
+    for (auto cell = bucket(shard, point);; cell = (cell + 1) & mask)
+    {
+        const auto position = shard.table[cell];
+
+        if (position == none || shard.pool[position].point == point)
+            return position;
+    }
+}
+
+// Place the pooled entry in the first empty bucket from its own.
+void unspent_outputs::index(shard& shard, slot position)
+{
+    const auto mask = shard.table.size() - 1;
+    auto cell = bucket(shard, shard.pool[position].point);
+
+    while (shard.table[cell] != none)
+        cell = (cell + 1) & mask;
+
+    shard.table[cell] = position;
+}
+
+// Clear the entry's bucket, shifting back later entries of the probe run that
+// would otherwise become unreachable (no tombstones).
+void unspent_outputs::deindex(shard& shard, slot position)
+{
+    const auto mask = shard.table.size() - 1;
+    auto hole = bucket(shard, shard.pool[position].point);
+
+    while (shard.table[hole] != position)
+        hole = (hole + 1) & mask;
+
+    for (auto cell = (hole + 1) & mask; shard.table[cell] != none;
+        cell = (cell + 1) & mask)
+    {
+        const auto home = bucket(shard, shard.pool[shard.table[cell]].point);
+
+        // Move the entry if its own bucket is not after the hole in the run.
+        if (((cell - home) & mask) >= ((cell - hole) & mask))
+        {
+            shard.table[hole] = shard.table[cell];
+            hole = cell;
+        }
+    }
+
+    shard.table[hole] = none;
+}
+
+// Link the entry as newest.
+void unspent_outputs::link(shard& shard, slot position)
+{
+    auto& item = shard.pool[position];
+    item.older = shard.newest;
+    item.newer = none;
+
+    if (shard.newest == none)
+        shard.oldest = position;
+    else
+        shard.pool[shard.newest].newer = position;
+
+    shard.newest = position;
+}
+
+// Unlink the entry from the age list.
+void unspent_outputs::unlink(shard& shard, slot position)
+{
+    const auto& item = shard.pool[position];
+
+    if (item.older == none)
+        shard.oldest = item.newer;
+    else
+        shard.pool[item.older].newer = item.newer;
+
+    if (item.newer == none)
+        shard.newest = item.older;
+    else
+        shard.pool[item.newer].older = item.older;
+}
+
+// Unlink the entry and return its slot to the pool.
+void unspent_outputs::erase(shard& shard, slot position)
+{
+    auto& item = shard.pool[position];
+    deindex(shard, position);
+    unlink(shard, position);
+    shard.usage -= footprint(item);
+    data_chunk().swap(item.oversized_script);
+    shard.free.push_back(position);
+}
+
+// Evict the oldest entry, sparing (and clearing) those read since considered.
+void unspent_outputs::evict(shard& shard)
+{
+    if (policy_ != eviction_policy::fifo)
+    {
+        // Terminates because each pass clears a flag (readers are excluded).
+        while (shard.referenced[shard.oldest].load(std::memory_order_relaxed))
+        {
+            const auto position = shard.oldest;
+            shard.referenced[position].store(false, std::memory_order_relaxed);
+            unlink(shard, position);
+            link(shard, position);
+        }
+    }
+
+    erase(shard, shard.oldest);
+}
+
+// Link the entry as newest, evicting entries until it fits.
+void unspent_outputs::insert(shard& shard, entry&& entry)
+{
+    const auto cost = footprint(entry);
+
+    if (cost > shard.capacity)
+        return;
+
+    while (shard.usage + cost > shard.capacity)
+        evict(shard);
+
+    slot position;
+
+    if (shard.free.empty())
+    {
+        position = static_cast<slot>(shard.pool.size());
+        shard.pool.push_back(std::move(entry));
+    }
+    else
+    {
+        position = shard.free.back();
+        shard.free.pop_back();
+        shard.pool[position] = std::move(entry);
+    }
+
+    if (policy_ != eviction_policy::fifo)
+    {
+        BITCOIN_ASSERT(position < shard.referenced.size());
+        shard.referenced[position].store(false, std::memory_order_relaxed);
+    }
+
+    link(shard, position);
+    index(shard, position);
+    shard.usage += cost;
 }
 
 bool unspent_outputs::disabled() const
@@ -37,30 +319,70 @@ bool unspent_outputs::disabled() const
     return capacity_ == 0;
 }
 
-size_t unspent_outputs::empty() const
+eviction_policy unspent_outputs::policy() const
 {
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
+    return policy_;
+}
 
-    return unspent_.empty();
-    ///////////////////////////////////////////////////////////////////////////
+size_t unspent_outputs::empty() const
+{
+    return size() == 0;
 }
 
 size_t unspent_outputs::size() const
 {
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
+    size_t total = 0;
 
-    return unspent_.size();
-    ///////////////////////////////////////////////////////////////////////////
+    for (const auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(shard.mutex);
+        total += shard.pool.size() - shard.free.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+size_t unspent_outputs::usage() const
+{
+    size_t total = 0;
+
+    for (const auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(shard.mutex);
+        total += shard.usage;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+size_t unspent_outputs::shards() const
+{
+    return shards_.size();
 }
 
 float unspent_outputs::hit_rate() const
 {
-    // These values could overflow or divide by zero, but that's okay.
-    return hits_ * 1.0f / queries_;
+    size_t hits = 0;
+    size_t queries = 0;
+
+    for (const auto& shard: shards_)
+    {
+        hits += shard.hits;
+        queries += shard.queries;
+    }
+
+    // The ratio is one (not undefined) before any query.
+    if (queries == 0)
+        return 1.0f;
+
+    // These values could overflow, but that's okay.
+    return hits * 1.0f / queries;
 }
 
 void unspent_outputs::add(const transaction& transaction, size_t height,
@@ -69,54 +391,73 @@ void unspent_outputs::add(const transaction& transaction, size_t height,
     if (disabled() || transaction.outputs().empty())
         return;
 
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
+    const auto coinbase = transaction.is_coinbase();
+
+    // Coinbase outputs cannot be spent until mature, so are rarely read.
+    if (coinbase && policy_ == eviction_policy::selective)
+        return;
 
-    // It's been a long time since the last restart (~16 years).
-    if (sequence_ == max_uint32)
-        unspent_.clear();
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto height32 = static_cast<uint32_t>(height);
+    const auto hash = transaction.hash();
+    const auto& outputs = transaction.outputs();
+    auto& shard = get_shard(hash);
 
-    // Remove the oldest entry if the buffer is at capacity.
-    if (unspent_.size() >= capacity_)
-        unspent_.right.erase(unspent_.right.begin());
+    // Entries are populated outside of the critical section.
+    std::vector<entry> entries;
+    entries.reserve(outputs.size());
 
-    unspent_.insert(
+    for (uint32_t index = 0; index < outputs.size(); ++index)
     {
-        unspent_transaction{ transaction, height, median_time_past, confirmed },
-        ++sequence_
-    });
+        const auto& output = outputs[index];
+
+        // Provably unspendable outputs are never fetched.
+        if (output.script().is_unspendable())
+            continue;
+
+        entry item;
+        item.point = { hash, index };
+        item.value = output.value();
+        item.height = height32;
+        item.median_time_past = median_time_past;
+        item.coinbase = coinbase;
+        item.confirmed = confirmed;
+        set_script(item, output.script().to_data(false));
+        entries.push_back(std::move(item));
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(shard.mutex);
+
+    for (auto& item: entries)
+        if (find(shard, item.point) == none)
+            insert(shard, std::move(item));
     ///////////////////////////////////////////////////////////////////////////
 }
 
 // This is confirmation-independent, since the conflict is extrememly rare and
 // the difference is simply an optimization. This avoids dual key indexing.
-void unspent_outputs::remove(const hash_digest& tx_hash)
+void unspent_outputs::remove(const transaction& transaction)
 {
     if (disabled())
         return;
 
-    const unspent_transaction key{ tx_hash };
+    const auto hash = transaction.hash();
+    const auto count = transaction.outputs().size();
+    auto& shard = get_shard(hash);
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_upgrade();
+    unique_lock lock(shard.mutex);
 
-    // Find the unspent tx entry.
-    const auto tx = unspent_.left.find(key);
-
-    if (tx == unspent_.left.end())
+    for (uint32_t index = 0; index < count; ++index)
     {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    unspent_.left.erase(tx);
+        const auto position = find(shard, { hash, index });
 
-    mutex_.unlock();
+        if (position != none)
+            erase(shard, position);
+    }
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -125,34 +466,27 @@ void unspent_outputs::remove(const output_point& point)
     if (disabled())
         return;
 
-    const unspent_transaction key{ point };
+    auto& shard = get_shard(point.hash());
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_upgrade();
+    shard.mutex.lock_upgrade();
 
-    // Find the unspent tx entry that may contain the output.
-    auto tx = unspent_.left.find(key);
+    // Find the unspent output entry.
+    const auto position = find(shard, point);
 
-    if (tx == unspent_.left.end())
+    if (position == none)
     {
-        mutex_.unlock_upgrade();
+        shard.mutex.unlock_upgrade();
         //---------------------------------------------------------------------
         return;
     }
 
-    const auto outputs = tx->first.outputs();
-    mutex_.unlock_upgrade_and_lock();
+    shard.mutex.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    erase(shard, position);
 
-    // Erase the output if found at the specified index for the found tx.
-    outputs->erase(point.index());
-
-    // Erase the unspent transaction if it is now fully spent.
-    if (outputs->empty())
-        unspent_.left.erase(tx);
-
-    mutex_.unlock();
+    shard.mutex.unlock();
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -164,42 +498,163 @@ bool unspent_outputs::get(output& out_output, size_t& out_height,
     if (disabled())
         return false;
 
-    ++queries_;
-    const unspent_transaction key{ point };
+    auto& shard = get_shard(point.hash());
+    ++shard.queries;
+
+    uint64_t value;
+    data_chunk script;
 
+    ///////////////////////////////////////////////////////////////////////////
     // Critical Section
+    shard.mutex.lock_shared();
+
+    // Find the unspent output entry.
+    const auto position = find(shard, point);
+
+    if (position == none)
+    {
+        shard.mutex.unlock_shared();
+        return false;
+    }
+
+    // Determine if the cached output is above specified fork_height.
+    // Since the hash table does not allow duplicates there are no others.
+    const auto& item = shard.pool[position];
+
+    if ((require_confirmed && !item.confirmed) || item.height > fork_height)
+    {
+        shard.mutex.unlock_shared();
+        return false;
+    }
+
+    // The flag is atomic, so may be set under the shared lock.
+    if (policy_ != eviction_policy::fifo)
+        shard.referenced[position].store(true, std::memory_order_relaxed);
+
+    out_height = item.height;
+    out_median_time_past = item.median_time_past;
+    out_coinbase = item.coinbase;
+    value = item.value;
+    script = get_script(item);
+
+    shard.mutex.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
 
-    // Find the unspent tx entry.
-    const auto tx = unspent_.left.find(key);
+    ++shard.hits;
+    out_output = output{ value, chain::script{ script, false } };
+    return true;
+}
 
-    if (tx == unspent_.left.end() ||
-        (require_confirmed && !tx->first.is_confirmed()))
+bool unspent_outputs::save(const boost::filesystem::path& file,
+    const hash_digest& tag) const
+{
+    if (disabled())
         return false;
 
-    // Find the output at the specified index for the found unspent tx.
-    const auto outputs = tx->first.outputs();
-    const auto output = outputs->find(point.index());
+    bc::ofstream stream(file.string(), std::ios::binary);
 
-    if (output == outputs->end())
+    if (!stream.good())
         return false;
 
-    // Determine if the cached unspent tx is above specified fork_height.
-    // Since the hash table does not allow duplicates there are no others.
-    const auto& unspent = tx->first;
-    const auto height = unspent.height();
+    ostream_writer sink(stream);
+    sink.write_4_bytes_little_endian(snapshot_version);
+    sink.write_hash(tag);
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(shards_.size()));
+
+    for (const auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(shard.mutex);
+        const auto count = static_cast<uint32_t>(shard.pool.size() -
+            shard.free.size());
+        sink.write_4_bytes_little_endian(count);
+
+        for (auto position = shard.oldest; position != none;
+            position = shard.pool[position].newer)
+        {
+            const auto& item = shard.pool[position];
+            const auto script = get_script(item);
+            sink.write_hash(item.point.hash());
+            sink.write_4_bytes_little_endian(item.point.index());
+            sink.write_4_bytes_little_endian(item.height);
+            sink.write_4_bytes_little_endian(item.median_time_past);
+            sink.write_byte((item.coinbase ? coinbase_flag : 0) |
+                (item.confirmed ? confirmed_flag : 0));
+            sink.write_8_bytes_little_endian(item.value);
+            sink.write_variable_little_endian(script.size());
+            sink.write_bytes(script);
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    stream.flush();
+    return stream.good();
+}
 
-    if (height > fork_height)
+// Outputs are added oldest first, so relative age is preserved.
+bool unspent_outputs::load(const boost::filesystem::path& file,
+    const hash_digest& tag)
+{
+    if (disabled())
         return false;
 
-    ++hits_;
-    out_height = height;
-    out_median_time_past = unspent.median_time_past();
-    out_coinbase = unspent.is_coinbase();
-    out_output = output->second;
-    return true;
-    ///////////////////////////////////////////////////////////////////////////
+    bc::ifstream stream(file.string(), std::ios::binary);
+
+    if (!stream.good())
+        return false;
+
+    istream_reader source(stream);
+    const auto version = source.read_4_bytes_little_endian();
+    const auto hash = source.read_hash();
+
+    if (!source || version != snapshot_version || hash != tag)
+        return false;
+
+    const auto shards = source.read_4_bytes_little_endian();
+
+    for (uint32_t index = 0; source && index < shards; ++index)
+    {
+        const auto count = source.read_4_bytes_little_endian();
+
+        for (uint32_t counter = 0; source && counter < count; ++counter)
+        {
+            entry item;
+            const auto tx_hash = source.read_hash();
+            item.point = { tx_hash, source.read_4_bytes_little_endian() };
+            item.height = source.read_4_bytes_little_endian();
+            item.median_time_past = source.read_4_bytes_little_endian();
+            const auto flags = source.read_byte();
+            item.coinbase = (flags & coinbase_flag) != 0;
+            item.confirmed = (flags & confirmed_flag) != 0;
+            item.value = source.read_8_bytes_little_endian();
+            const auto size = source.read_size_little_endian();
+
+            // Guard against allocation from a corrupted snapshot.
+            if (!source || size > max_script_size)
+                return false;
+
+            set_script(item, source.read_bytes(size));
+
+            if (!source)
+                return false;
+
+            if (item.coinbase && policy_ == eviction_policy::selective)
+                continue;
+
+            auto& target = get_shard(tx_hash);
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            unique_lock lock(target.mutex);
+
+            if (find(target, item.point) == none)
+                insert(target, std::move(item));
+            ///////////////////////////////////////////////////////////////////
+        }
+    }
+
+    return static_cast<bool>(source);
 }
 
 } // namespace database
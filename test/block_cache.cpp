@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+
+BOOST_AUTO_TEST_SUITE(block_cache_tests)
+
+static const hash_digest hash1{ { 1 } };
+static const hash_digest hash2{ { 2 } };
+static const hash_digest hash3{ { 3 } };
+
+BOOST_AUTO_TEST_CASE(block_cache__construct__capacity_0__disabled)
+{
+    const block_cache cache(0);
+    BOOST_REQUIRE(cache.disabled());
+}
+
+BOOST_AUTO_TEST_CASE(block_cache__add__capacity_0__not_cached)
+{
+    block_cache cache(0);
+    cache.add(hash1, data_chunk(10, 0x42));
+    BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+    BOOST_REQUIRE(!cache.get(hash1));
+}
+
+BOOST_AUTO_TEST_CASE(block_cache__get__added__expected)
+{
+    block_cache cache(100);
+    cache.add(hash1, data_chunk(10, 0x42));
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.usage(), 10u);
+
+    const auto data = cache.get(hash1);
+    BOOST_REQUIRE(data);
+    BOOST_REQUIRE(*data == data_chunk(10, 0x42));
+    BOOST_REQUIRE(!cache.get(hash2));
+}
+
+BOOST_AUTO_TEST_CASE(block_cache__add__over_capacity__least_recently_used_evicted)
+{
+    block_cache cache(25);
+    cache.add(hash1, data_chunk(10, 1));
+    cache.add(hash2, data_chunk(10, 2));
+
+    // Reading the first makes the second least recently used.
+    BOOST_REQUIRE(cache.get(hash1));
+    cache.add(hash3, data_chunk(10, 3));
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE_EQUAL(cache.usage(), 20u);
+    BOOST_REQUIRE(cache.get(hash1));
+    BOOST_REQUIRE(!cache.get(hash2));
+    BOOST_REQUIRE(cache.get(hash3));
+}
+
+BOOST_AUTO_TEST_CASE(block_cache__add__larger_than_capacity__not_cached)
+{
+    block_cache cache(25);
+    cache.add(hash1, data_chunk(10, 1));
+    cache.add(hash2, data_chunk(26, 2));
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE(cache.get(hash1));
+}
+
+BOOST_AUTO_TEST_CASE(block_cache__remove__cached__removed)
+{
+    block_cache cache(100);
+    cache.add(hash1, data_chunk(10, 1));
+    cache.remove(hash1);
+    BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.usage(), 0u);
+    BOOST_REQUIRE(!cache.get(hash1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
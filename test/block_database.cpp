@@ -16,6 +16,9 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 #include <bitcoin/database.hpp>
@@ -170,6 +173,8 @@ BOOST_AUTO_TEST_CASE(block_database__test)
         auto res_h2 = db.get(h2, true);
         BOOST_REQUIRE(res_h2);
         BOOST_REQUIRE(res_h2.hash() == h2);
+        BOOST_REQUIRE_EQUAL(res_h2.checksum(), block_database::checksum(block2));
+        BOOST_REQUIRE_NE(res_h2.checksum(), 0u);
 
         // TODO: set tx association into metadata and validate here.
         ////BOOST_REQUIRE(res_h2.transaction_hash(0) == block2.transactions()[0].hash());
@@ -246,4 +251,407 @@ BOOST_AUTO_TEST_CASE(block_database__test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(block_database__compact__test)
+{
+    const auto block0 = block::genesis_mainnet();
+    const auto h0 = block0.hash();
+    const message::compact_block::short_id_list ids
+    {
+        { { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 } },
+        { { 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 } }
+    };
+
+    const message::compact_block compact(block0.header(), 42, ids,
+        message::prefilled_transaction::list{});
+
+    store::create(DIRECTORY "/block_index_compact");
+    store::create(DIRECTORY "/block_table_compact");
+    store::create(DIRECTORY "/tx_index_compact");
+    block_database db(DIRECTORY "/block_index_compact", DIRECTORY "/block_table_compact", DIRECTORY "/tx_index_compact", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    // Short ids are stored in place of tx offsets.
+    BOOST_REQUIRE(db.store(compact, 0));
+
+    // The result holds the remap lock, so is released before updating.
+    {
+        const auto result = db.get(h0, false);
+        BOOST_REQUIRE(result);
+        BOOST_REQUIRE(result.compact());
+        BOOST_REQUIRE_EQUAL(result.transaction_count(), 2u);
+        BOOST_REQUIRE(result.transaction_offsets().empty());
+
+        const auto short_ids = result.short_ids();
+        BOOST_REQUIRE_EQUAL(short_ids.size(), 2u);
+        BOOST_REQUIRE_EQUAL(short_ids[0], 0x060504030201u);
+        BOOST_REQUIRE_EQUAL(short_ids[1], 0x010203040506u);
+    }
+
+    // Prefilled indexes past the last slot, or overflowing, are rejected.
+    const auto coinbase = block0.transactions().front();
+    const message::compact_block past(block0.header(), 42, ids,
+        { { 0, coinbase }, { 2, coinbase } });
+    const message::compact_block overflow(block0.header(), 42, ids,
+        { { 1, coinbase }, { max_uint64, coinbase } });
+    BOOST_REQUIRE(!db.update(past, 0));
+    BOOST_REQUIRE(!db.update(overflow, 0));
+
+    // A valid prefilled tx is assigned its computed short id in place.
+    const message::compact_block prefilled(block0.header(), 42, ids,
+        { { 1, coinbase } });
+    BOOST_REQUIRE(db.update(prefilled, 0));
+    BOOST_REQUIRE_EQUAL(db.get(h0, false).transaction_count(), 3u);
+    BOOST_REQUIRE_EQUAL(db.get(h0, false).short_ids()[1], to_short_id(short_id_key(prefilled), coinbase.hash()));
+    db.synchronize();
+}
+
+BOOST_AUTO_TEST_CASE(block_database__cache_headers__test)
+{
+    const auto block0 = block::genesis_mainnet();
+    auto block1 = block0;
+    block1.header().set_nonce(1);
+    block1.header().set_previous_block_hash(block0.hash());
+    auto block2 = block0;
+    block2.header().set_nonce(2);
+    block2.header().set_previous_block_hash(block1.hash());
+
+    store::create(DIRECTORY "/block_index_cached");
+    store::create(DIRECTORY "/block_table_cached");
+    store::create(DIRECTORY "/tx_index_cached");
+
+    {
+        block_database db(DIRECTORY "/block_index_cached", DIRECTORY "/block_table_cached", DIRECTORY "/tx_index_cached", 1000, 50, true);
+        BOOST_REQUIRE(db.create());
+        db.store(block0, 0, true);
+        db.store(block1, 1, true);
+        db.store(block2, 2, true);
+
+        hash_digest hash;
+        BOOST_REQUIRE(db.get_hash(hash, 1));
+        BOOST_REQUIRE(hash == block1.hash());
+        BOOST_REQUIRE(!db.get_hash(hash, 3));
+
+        header result;
+        BOOST_REQUIRE(db.get_header(result, 2));
+        BOOST_REQUIRE(result == block2.header());
+
+        const auto headers = db.get_headers(1, 5);
+        BOOST_REQUIRE_EQUAL(headers.size(), 2u);
+        BOOST_REQUIRE(headers[0] == block1.header());
+        BOOST_REQUIRE(headers[1] == block2.header());
+
+        hash_list locator;
+        BOOST_REQUIRE(db.get_locator(locator, { 2, 0 }));
+        BOOST_REQUIRE_EQUAL(locator.size(), 2u);
+        BOOST_REQUIRE(locator[0] == block2.hash());
+        BOOST_REQUIRE(locator[1] == block0.hash());
+
+        // Unconfirmed heights are removed from the cache.
+        BOOST_REQUIRE(db.unconfirm(2));
+        BOOST_REQUIRE(!db.get(block2.hash(), false).confirmed());
+        BOOST_REQUIRE(db.get(block1.hash(), false).confirmed());
+        BOOST_REQUIRE(!db.get_hash(hash, 2));
+        BOOST_REQUIRE(!db.get_locator(locator, { 2, 0 }));
+        db.synchronize();
+        BOOST_REQUIRE(db.close());
+    }
+
+    // The cache is loaded from the block index on open.
+    block_database db(DIRECTORY "/block_index_cached", DIRECTORY "/block_table_cached", DIRECTORY "/tx_index_cached", 1000, 50, true);
+    BOOST_REQUIRE(db.open());
+
+    hash_digest hash;
+    BOOST_REQUIRE(db.get_hash(hash, 0));
+    BOOST_REQUIRE(hash == block0.hash());
+    BOOST_REQUIRE(db.get_hash(hash, 1));
+    BOOST_REQUIRE(hash == block1.hash());
+    BOOST_REQUIRE(!db.get_hash(hash, 2));
+}
+
+BOOST_AUTO_TEST_CASE(block_database__store_headers__test)
+{
+    const auto header0 = block::genesis_mainnet().header();
+    auto header1 = header0;
+    header1.set_nonce(1);
+    header1.set_previous_block_hash(header0.hash());
+    auto header2 = header0;
+    header2.set_nonce(2);
+    header2.set_previous_block_hash(header1.hash());
+    auto header3 = header0;
+    header3.set_nonce(3);
+    header3.set_previous_block_hash(header2.hash());
+
+    store::create(DIRECTORY "/block_index_batch");
+    store::create(DIRECTORY "/block_table_batch");
+    store::create(DIRECTORY "/tx_index_batch");
+    block_database db(DIRECTORY "/block_index_batch", DIRECTORY "/block_table_batch", DIRECTORY "/tx_index_batch", 1000, 50, true);
+    BOOST_REQUIRE(db.create());
+
+    // Unconfirmed headers are not indexed by height.
+    db.store({ header0, header1 }, 0, false);
+    BOOST_REQUIRE(!db.exists(0));
+
+    const auto result1 = db.get(header1.hash(), false);
+    BOOST_REQUIRE(result1);
+    BOOST_REQUIRE(!result1.confirmed());
+    BOOST_REQUIRE_EQUAL(result1.height(), 1u);
+    BOOST_REQUIRE_EQUAL(result1.transaction_count(), 0u);
+    BOOST_REQUIRE_EQUAL(result1.checksum(), 0u);
+    BOOST_REQUIRE(result1.header() == header1);
+
+    // Confirmed headers are indexed by height, creating a gap below.
+    db.store({ header2, header3 }, 2, true);
+    BOOST_REQUIRE(!db.exists(0));
+    BOOST_REQUIRE(!db.exists(1));
+    BOOST_REQUIRE(db.exists(2));
+    BOOST_REQUIRE(db.exists(3));
+
+    size_t top;
+    BOOST_REQUIRE(db.top(top));
+    BOOST_REQUIRE_EQUAL(top, 3u);
+    BOOST_REQUIRE(db.get(3).hash() == header3.hash());
+
+    hash_digest hash;
+    BOOST_REQUIRE(db.get_hash(hash, 2));
+    BOOST_REQUIRE(hash == header2.hash());
+    BOOST_REQUIRE(!db.get_hash(hash, 1));
+}
+
+BOOST_AUTO_TEST_CASE(block_database__gaps__test)
+{
+    const auto header0 = block::genesis_mainnet().header();
+    auto header1 = header0;
+    header1.set_nonce(1);
+    auto header2 = header0;
+    header2.set_nonce(2);
+
+    store::create(DIRECTORY "/block_index_gaps");
+    store::create(DIRECTORY "/block_table_gaps");
+    store::create(DIRECTORY "/tx_index_gaps");
+
+    {
+        block_database db(DIRECTORY "/block_index_gaps", DIRECTORY "/block_table_gaps", DIRECTORY "/tx_index_gaps", 1000, 50);
+        BOOST_REQUIRE(db.create());
+
+        // [0][_][_][3][_][5]
+        db.store({ header0 }, 0, true);
+        db.store({ header1 }, 3, true);
+        db.store({ header2 }, 5, true);
+
+        block_database::heights gaps;
+        BOOST_REQUIRE(db.gaps(gaps));
+        BOOST_REQUIRE_EQUAL(gaps.size(), 3u);
+        BOOST_REQUIRE_EQUAL(gaps[0], 1u);
+        BOOST_REQUIRE_EQUAL(gaps[1], 2u);
+        BOOST_REQUIRE_EQUAL(gaps[2], 4u);
+
+        // [0][1][_][3][_][5]
+        db.store({ header1 }, 1, true);
+        const auto missing = db.missing();
+        BOOST_REQUIRE_EQUAL(missing.size(), 2u);
+        BOOST_REQUIRE_EQUAL(missing[0].first, 2u);
+        BOOST_REQUIRE_EQUAL(missing[0].count, 1u);
+        BOOST_REQUIRE_EQUAL(missing[1].first, 4u);
+        BOOST_REQUIRE_EQUAL(missing[1].count, 1u);
+
+        db.synchronize();
+        BOOST_REQUIRE(db.close());
+    }
+
+    // Gaps are recovered from the block index on open.
+    block_database db(DIRECTORY "/block_index_gaps", DIRECTORY "/block_table_gaps", DIRECTORY "/tx_index_gaps", 1000, 50);
+    BOOST_REQUIRE(db.open());
+    BOOST_REQUIRE_EQUAL(db.missing().size(), 2u);
+
+    // [0][1][_]
+    BOOST_REQUIRE(db.unconfirm(3));
+    const auto missing = db.missing();
+    BOOST_REQUIRE_EQUAL(missing.size(), 1u);
+    BOOST_REQUIRE_EQUAL(missing[0].first, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(block_database__unconfirm__across_gaps__unconfirmed)
+{
+    header::list headers(5, block::genesis_mainnet().header());
+
+    for (uint32_t nonce = 0; nonce < headers.size(); ++nonce)
+        headers[nonce].set_nonce(nonce);
+
+    store::create(DIRECTORY "/block_index_unconfirm");
+    store::create(DIRECTORY "/block_table_unconfirm");
+    store::create(DIRECTORY "/tx_index_unconfirm");
+    block_database db(DIRECTORY "/block_index_unconfirm", DIRECTORY "/block_table_unconfirm", DIRECTORY "/tx_index_unconfirm", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    // [0][_][2][_][4]
+    db.store({ headers[0] }, 0, true);
+    db.store({ headers[2] }, 2, true);
+    db.store({ headers[4] }, 4, true);
+    BOOST_REQUIRE(!db.get(1));
+    BOOST_REQUIRE(!db.get(3));
+
+    // Gaps are skipped, the blocks above them are demoted.
+    BOOST_REQUIRE(db.unconfirm(1));
+    BOOST_REQUIRE(db.missing().empty());
+    BOOST_REQUIRE(!db.exists(2));
+    BOOST_REQUIRE(!db.get(4));
+    BOOST_REQUIRE(db.get(0).confirmed());
+    BOOST_REQUIRE(db.get(headers[2].hash(), false));
+    BOOST_REQUIRE(!db.get(headers[2].hash(), false).confirmed());
+    BOOST_REQUIRE(!db.get(headers[4].hash(), false).confirmed());
+    BOOST_REQUIRE(!db.get(headers[4].hash(), true));
+}
+
+BOOST_AUTO_TEST_CASE(block_database__unconfirm__concurrent_get__consistent)
+{
+    static const size_t count = 200;
+    static const size_t from_height = 100;
+    header::list headers(count, block::genesis_mainnet().header());
+
+    for (uint32_t nonce = 0; nonce < headers.size(); ++nonce)
+        headers[nonce].set_nonce(nonce);
+
+    store::create(DIRECTORY "/block_index_concurrent");
+    store::create(DIRECTORY "/block_table_concurrent");
+    store::create(DIRECTORY "/tx_index_concurrent");
+    block_database db(DIRECTORY "/block_index_concurrent", DIRECTORY "/block_table_concurrent", DIRECTORY "/tx_index_concurrent", 1000, 50);
+    BOOST_REQUIRE(db.create());
+    db.store(headers, 0, true);
+
+    std::atomic<bool> done(false);
+    std::atomic<size_t> inconsistent(0);
+    std::vector<std::thread> readers;
+
+    // A result is either confirmed (before) or not found (after), never an
+    // unconfirmed block at a confirmed height.
+    for (size_t reader = 0; reader < 4; ++reader)
+        readers.emplace_back([&]()
+        {
+            while (!done)
+                for (auto height = from_height; height < count; ++height)
+                {
+                    const auto result = db.get(height);
+
+                    if (result && (!result.confirmed() ||
+                        result.hash() != headers[height].hash()))
+                        ++inconsistent;
+                }
+        });
+
+    BOOST_REQUIRE(db.unconfirm(from_height));
+    done = true;
+
+    for (auto& reader: readers)
+        reader.join();
+
+    BOOST_REQUIRE_EQUAL(inconsistent.load(), 0u);
+    BOOST_REQUIRE(!db.get(from_height));
+    BOOST_REQUIRE(db.get(from_height - 1).confirmed());
+}
+
+BOOST_AUTO_TEST_CASE(block_database__transaction_offsets__test)
+{
+    auto block0 = block::genesis_mainnet();
+    block0.set_transactions(
+    {
+        random_tx(0),
+        random_tx(1)
+    });
+    block0.transactions()[0].validation.offset = 42;
+    block0.transactions()[1].validation.offset = 99;
+
+    store::create(DIRECTORY "/block_index_offsets");
+    store::create(DIRECTORY "/block_table_offsets");
+    store::create(DIRECTORY "/tx_index_offsets");
+    block_database db(DIRECTORY "/block_index_offsets", DIRECTORY "/block_table_offsets", DIRECTORY "/tx_index_offsets", 1000, 50);
+    BOOST_REQUIRE(db.create());
+    db.store(block0, 0, true);
+
+    // Offsets are iterated in place in the tx index.
+    const auto result = db.get(0);
+    BOOST_REQUIRE(result);
+    const auto offsets = result.transaction_offsets();
+    BOOST_REQUIRE_EQUAL(offsets.size(), 2u);
+
+    auto offset = offsets.begin();
+    BOOST_REQUIRE_EQUAL(*offset, 42u);
+    ++offset;
+    BOOST_REQUIRE_EQUAL(*offset, 99u);
+    ++offset;
+    BOOST_REQUIRE(offset == offsets.end());
+}
+
+BOOST_AUTO_TEST_CASE(block_database__get_height__median_time_past__test)
+{
+    header::list headers;
+    const auto genesis = block::genesis_mainnet().header();
+
+    // [0:100][1:200][2:200][_][4:400]
+    for (uint32_t nonce = 0; nonce < 5; ++nonce)
+    {
+        auto next = genesis;
+        next.set_nonce(nonce);
+        next.validation.median_time_past = nonce == 2 ? 200 : 100 * (nonce + 1);
+        headers.push_back(next);
+    }
+
+    store::create(DIRECTORY "/block_index_time");
+    store::create(DIRECTORY "/block_table_time");
+    store::create(DIRECTORY "/tx_index_time");
+    block_database db(DIRECTORY "/block_index_time", DIRECTORY "/block_table_time", DIRECTORY "/tx_index_time", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    size_t height;
+    BOOST_REQUIRE(!db.get_height(height, 0));
+
+    db.store({ headers[0], headers[1], headers[2] }, 0, true);
+    db.store({ headers[4] }, 4, true);
+
+    BOOST_REQUIRE(db.get_height(height, 0));
+    BOOST_REQUIRE_EQUAL(height, 0u);
+    BOOST_REQUIRE(db.get_height(height, 150));
+    BOOST_REQUIRE_EQUAL(height, 1u);
+    BOOST_REQUIRE(db.get_height(height, 200));
+    BOOST_REQUIRE_EQUAL(height, 1u);
+    BOOST_REQUIRE(db.get_height(height, 201));
+    BOOST_REQUIRE_EQUAL(height, 4u);
+    BOOST_REQUIRE(db.get_height(height, 400));
+    BOOST_REQUIRE_EQUAL(height, 4u);
+    BOOST_REQUIRE(!db.get_height(height, 401));
+}
+
+BOOST_AUTO_TEST_CASE(block_database__get_height__median_time_past_gap_run__test)
+{
+    header::list headers;
+    const auto genesis = block::genesis_mainnet().header();
+
+    // [0:100][1:200][2:300][_][_][_][_][_][_][9:1000]
+    for (uint32_t nonce = 0; nonce < 10; ++nonce)
+    {
+        auto next = genesis;
+        next.set_nonce(nonce);
+        next.validation.median_time_past = 100 * (nonce + 1);
+        headers.push_back(next);
+    }
+
+    store::create(DIRECTORY "/block_index_time_run");
+    store::create(DIRECTORY "/block_table_time_run");
+    store::create(DIRECTORY "/tx_index_time_run");
+    block_database db(DIRECTORY "/block_index_time_run", DIRECTORY "/block_table_time_run", DIRECTORY "/tx_index_time_run", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    db.store({ headers[0], headers[1], headers[2] }, 0, true);
+    db.store({ headers[9] }, 9, true);
+
+    // A jump over the gap run passes the narrowed upper bound.
+    size_t height;
+    BOOST_REQUIRE(db.get_height(height, 301));
+    BOOST_REQUIRE_EQUAL(height, 9u);
+    BOOST_REQUIRE(db.get_height(height, 300));
+    BOOST_REQUIRE_EQUAL(height, 2u);
+    BOOST_REQUIRE(db.get_height(height, 1000));
+    BOOST_REQUIRE_EQUAL(height, 9u);
+    BOOST_REQUIRE(!db.get_height(height, 1001));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
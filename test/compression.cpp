@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::database;
+
+BOOST_AUTO_TEST_SUITE(compression_tests)
+
+BOOST_AUTO_TEST_CASE(compression__amount__round_trip__expected)
+{
+    static const uint64_t values[] =
+    {
+        0, 1, 9, 10, 99, 100, 123456789, 5000000000, 2100000000000000
+    };
+
+    for (const auto value: values)
+        BOOST_REQUIRE_EQUAL(decompress_amount(compress_amount(value)), value);
+
+    // Round values compress to small integers.
+    BOOST_REQUIRE_EQUAL(compress_amount(5000000000), 50u);
+}
+
+BOOST_AUTO_TEST_CASE(compression__amount__above_max_money__escaped)
+{
+    static const uint64_t values[] =
+    {
+        max_money() + 1, chain::output::not_found, max_uint64 / 9 + 1
+    };
+
+    for (const auto value: values)
+    {
+        BOOST_REQUIRE_EQUAL(compress_amount(value), amount_escape);
+
+        data_chunk data(compressed_amount_size(value));
+        BOOST_REQUIRE_EQUAL(data.size(), variable_uint_size(amount_escape) + sizeof(uint64_t));
+
+        auto serial = make_unsafe_serializer(data.begin());
+        compress_amount(serial, value);
+
+        auto deserial = make_unsafe_deserializer(data.begin());
+        BOOST_REQUIRE_EQUAL(decompress_amount(deserial), value);
+    }
+
+    // Amounts within max_money are written as the compressed code alone.
+    data_chunk data(compressed_amount_size(max_money()));
+    BOOST_REQUIRE_EQUAL(data.size(), variable_uint_size(compress_amount(max_money())));
+
+    auto serial = make_unsafe_serializer(data.begin());
+    compress_amount(serial, max_money());
+
+    auto deserial = make_unsafe_deserializer(data.begin());
+    BOOST_REQUIRE_EQUAL(decompress_amount(deserial), max_money());
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__pay_key_hash__compressed)
+{
+    data_chunk data;
+    BOOST_REQUIRE(decode_base16(data, "76a914fe06e7b4c88a719e92373de489c08244aee4520b88ac"));
+    const script script(data, false);
+
+    data_chunk compressed(compressed_script_size(script));
+    BOOST_REQUIRE_EQUAL(compressed.size(), 1u + short_hash_size);
+
+    auto serial = make_unsafe_serializer(compressed.begin());
+    compress_script(serial, script);
+
+    const auto code = compressed.front();
+    BOOST_REQUIRE_EQUAL(script_payload_size(code), short_hash_size);
+    BOOST_REQUIRE_EQUAL(script_size(code), data.size());
+    BOOST_REQUIRE(decompress_script(code, &compressed[1]) == data);
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__nonstandard__raw)
+{
+    data_chunk data;
+    BOOST_REQUIRE(decode_base16(data, "6a0401020304"));
+    const script script(data, false);
+
+    data_chunk compressed(compressed_script_size(script));
+    BOOST_REQUIRE_EQUAL(compressed.size(), 1u + data.size());
+
+    auto serial = make_unsafe_serializer(compressed.begin());
+    compress_script(serial, script);
+
+    const auto code = compressed.front();
+    BOOST_REQUIRE_EQUAL(script_payload_size(code), data.size());
+    BOOST_REQUIRE(decompress_script(code, &compressed[1]) == data);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
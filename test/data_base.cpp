@@ -312,6 +312,29 @@ static code pop_above_result(data_base_accessor& instance,
     return promise.get_future().get();
 }
 
+static transaction make_transaction(const output_point& prevout, uint8_t tag)
+{
+    // The tag distinguishes the hashes of otherwise identical coinbases.
+    const input::list inputs{ { prevout, script(data_chunk{ 0x01, tag }, false), max_input_sequence } };
+    const output::list outputs{ { 50, script(data_chunk{ 0x51 }, false) } };
+    return transaction(1, 0, inputs, outputs);
+}
+
+static block make_block(const transaction::list& transactions, uint32_t nonce)
+{
+    // The nonce distinguishes the hashes of otherwise identical headers.
+    return block(chain::header(1, null_hash, null_hash, 0, 0, nonce), transactions);
+}
+
+static bool is_unspent(const data_base& instance, const output_point& point)
+{
+    bool coinbase;
+    size_t height;
+    uint32_t median_time_past;
+    chain::output output;
+    return instance.unspents().get(output, height, median_time_past, coinbase, point);
+}
+
 BOOST_AUTO_TEST_CASE(data_base__pushpop__test)
 {
     std::cout << "begin data_base push/pop test" << std::endl;
@@ -324,6 +347,8 @@ BOOST_AUTO_TEST_CASE(data_base__pushpop__test)
     settings.index_start_height = 0;
     settings.block_table_buckets = 42;
     settings.transaction_table_buckets = 42;
+    settings.transaction_pool_table_buckets = 42;
+    settings.unspent_table_buckets = 42;
     settings.spend_table_buckets = 42;
     settings.history_table_buckets = 42;
 
@@ -408,4 +433,155 @@ BOOST_AUTO_TEST_CASE(data_base__pushpop__test)
     std::cout << "end push/pop test" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(data_base__insert__out_of_order__unspents_follow_contiguous_chain)
+{
+    create_directory(DIRECTORY);
+    database::settings settings;
+    settings.directory = DIRECTORY;
+    settings.flush_writes = false;
+    settings.file_growth_rate = 42;
+    settings.index_start_height = 0;
+    settings.block_table_buckets = 42;
+    settings.transaction_table_buckets = 42;
+    settings.transaction_pool_table_buckets = 42;
+    settings.unspent_table_buckets = 42;
+    settings.spend_table_buckets = 42;
+    settings.history_table_buckets = 42;
+
+    threadpool pool(1);
+    dispatcher dispatch(pool, "test");
+    data_base_accessor instance(settings);
+    const auto block0 = block::genesis_mainnet();
+    BOOST_REQUIRE(instance.create(block0));
+
+    const output_point null_point{ null_hash, point::null_index };
+    const auto coinbase1 = make_transaction(null_point, 1);
+    const auto coinbase2 = make_transaction(null_point, 2);
+    const auto coinbase3 = make_transaction(null_point, 3);
+    const output_point out1{ coinbase1.hash(), 0 };
+    const output_point out2{ coinbase2.hash(), 0 };
+    const output_point out3{ coinbase3.hash(), 0 };
+    const auto spend3 = make_transaction(out2, 4);
+    const output_point out4{ spend3.hash(), 0 };
+
+    const auto block1 = make_block({ coinbase1 }, 1);
+    const auto block2 = make_block({ coinbase2 }, 2);
+    const auto block3 = make_block({ coinbase3, spend3 }, 3);
+
+    // Heights above the gap at height 1 are deferred.
+    BOOST_REQUIRE_EQUAL(instance.insert(block2, 2), error::success);
+    BOOST_REQUIRE_EQUAL(instance.insert(block3, 3), error::success);
+    BOOST_REQUIRE(!is_unspent(instance, out2));
+    BOOST_REQUIRE(!is_unspent(instance, out3));
+    BOOST_REQUIRE(!is_unspent(instance, out4));
+
+    // Filling the gap applies all contiguous blocks in height order.
+    BOOST_REQUIRE_EQUAL(instance.insert(block1, 1), error::success);
+    BOOST_REQUIRE(is_unspent(instance, out1));
+    BOOST_REQUIRE(!is_unspent(instance, out2));
+    BOOST_REQUIRE(is_unspent(instance, out3));
+    BOOST_REQUIRE(is_unspent(instance, out4));
+
+    const auto blocks_popped_ptr = std::make_shared<block_const_ptr_list>();
+    BOOST_REQUIRE_EQUAL(pop_above_result(instance, blocks_popped_ptr, block0.hash(), dispatch), error::success);
+    BOOST_REQUIRE_EQUAL(blocks_popped_ptr->size(), 3u);
+    BOOST_REQUIRE(!is_unspent(instance, out1));
+    BOOST_REQUIRE(!is_unspent(instance, out2));
+    BOOST_REQUIRE(!is_unspent(instance, out3));
+    BOOST_REQUIRE(!is_unspent(instance, out4));
+    BOOST_REQUIRE(is_unspent(instance, { block0.transactions()[0].hash(), 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(data_base__push_transaction__confirmed_duplicate_not_in_unspents__unspent_duplicate)
+{
+    create_directory(DIRECTORY);
+    database::settings settings;
+    settings.directory = DIRECTORY;
+    settings.flush_writes = false;
+    settings.file_growth_rate = 42;
+    settings.index_start_height = store::without_indexes;
+    settings.block_table_buckets = 42;
+    settings.transaction_table_buckets = 42;
+    settings.transaction_pool_table_buckets = 42;
+    settings.unspent_table_buckets = 42;
+
+    data_base_accessor instance(settings);
+    BOOST_REQUIRE(instance.create(block::genesis_mainnet()));
+
+    const output_point null_point{ null_hash, point::null_index };
+    const input::list inputs{ { null_point, script(data_chunk{ 0x01, 0x01 }, false), max_input_sequence } };
+    const output::list outputs{ { 0, script(data_chunk{ 0x6a }, false) } };
+    const transaction unspendable(1, 0, inputs, outputs);
+    const auto above_gap = make_transaction(null_point, 2);
+
+    // An unspendable output is never stored in the unspent table.
+    BOOST_REQUIRE_EQUAL(instance.insert(make_block({ unspendable }, 1), 1), error::success);
+    BOOST_REQUIRE(!is_unspent(instance, { unspendable.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(instance.push(unspendable, 0), error::unspent_duplicate);
+
+    // A block above a gap is not yet applied to the unspent table.
+    BOOST_REQUIRE_EQUAL(instance.insert(make_block({ above_gap }, 3), 3), error::success);
+    BOOST_REQUIRE(!is_unspent(instance, { above_gap.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(instance.push(above_gap, 0), error::unspent_duplicate);
+}
+
+BOOST_AUTO_TEST_CASE(data_base__push_headers__height_and_parent__verified)
+{
+    create_directory(DIRECTORY);
+    database::settings settings;
+    settings.directory = DIRECTORY;
+    settings.flush_writes = false;
+    settings.file_growth_rate = 42;
+    settings.index_start_height = store::without_indexes;
+    settings.block_table_buckets = 42;
+    settings.transaction_table_buckets = 42;
+    settings.transaction_pool_table_buckets = 42;
+    settings.unspent_table_buckets = 42;
+
+    data_base instance(settings);
+    BOOST_REQUIRE(instance.create(block::genesis_mainnet()));
+
+    const auto header1 = read_block(MAINNET_BLOCK1).header();
+    const auto header2 = read_block(MAINNET_BLOCK2).header();
+    const auto header3 = read_block(MAINNET_BLOCK3).header();
+
+    // The height must follow the top, and the first must link to the top.
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header1, header2 }, 0), error::store_block_invalid_height);
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header2, header3 }, 1), error::store_block_missing_parent);
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header1, header3 }, 1), error::store_block_missing_parent);
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header1, header2 }, 1), error::success);
+
+    // A run may extend previously stored headers, at the following height.
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header3 }, 4), error::store_block_invalid_height);
+    BOOST_REQUIRE_EQUAL(instance.push(header::list{ header3 }, 3), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(data_base__open__compress_outputs_mismatch__false)
+{
+    create_directory(DIRECTORY);
+    database::settings settings;
+    settings.directory = DIRECTORY;
+    settings.flush_writes = false;
+    settings.file_growth_rate = 42;
+    settings.index_start_height = store::without_indexes;
+    settings.block_table_buckets = 42;
+    settings.transaction_table_buckets = 42;
+    settings.transaction_pool_table_buckets = 42;
+    settings.unspent_table_buckets = 42;
+    settings.compress_outputs = true;
+
+    data_base created(settings);
+    BOOST_REQUIRE(created.create(block::genesis_mainnet()));
+    BOOST_REQUIRE(created.close());
+
+    settings.compress_outputs = false;
+    data_base mismatched(settings);
+    BOOST_REQUIRE(!mismatched.open());
+
+    settings.compress_outputs = true;
+    data_base matched(settings);
+    BOOST_REQUIRE(matched.open());
+    BOOST_REQUIRE(matched.close());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
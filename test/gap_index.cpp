@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::database;
+
+BOOST_AUTO_TEST_SUITE(gap_index_tests)
+
+BOOST_AUTO_TEST_CASE(gap_index__construct__default__empty)
+{
+    const gap_index index;
+    BOOST_REQUIRE_EQUAL(index.size(), 0u);
+    BOOST_REQUIRE_EQUAL(index.count(), 0u);
+    BOOST_REQUIRE(index.get().empty());
+}
+
+BOOST_AUTO_TEST_CASE(gap_index__insert__adjacent_and_overlapping__merged)
+{
+    gap_index index;
+    index.insert(10, 5);
+    index.insert(20, 5);
+    BOOST_REQUIRE_EQUAL(index.size(), 2u);
+
+    index.insert(15, 2);
+    index.insert(18, 4);
+    BOOST_REQUIRE_EQUAL(index.size(), 1u);
+    BOOST_REQUIRE_EQUAL(index.count(), 15u);
+
+    const auto ranges = index.get();
+    BOOST_REQUIRE_EQUAL(ranges.front().first, 10u);
+    BOOST_REQUIRE_EQUAL(ranges.front().count, 15u);
+}
+
+BOOST_AUTO_TEST_CASE(gap_index__erase__interior__split)
+{
+    gap_index index;
+    index.insert(10, 10);
+    index.erase(12, 3);
+    index.erase(0, 11);
+    BOOST_REQUIRE_EQUAL(index.size(), 2u);
+
+    gap_index::heights heights;
+    index.get(heights);
+    BOOST_REQUIRE_EQUAL(heights.size(), 6u);
+    BOOST_REQUIRE_EQUAL(heights[0], 11u);
+    BOOST_REQUIRE_EQUAL(heights[1], 15u);
+    BOOST_REQUIRE_EQUAL(heights[5], 19u);
+}
+
+BOOST_AUTO_TEST_CASE(gap_index__truncate__spanning__trimmed)
+{
+    gap_index index;
+    index.insert(0, 5);
+    index.insert(10, 5);
+    index.truncate(3);
+    BOOST_REQUIRE_EQUAL(index.size(), 1u);
+    BOOST_REQUIRE_EQUAL(index.count(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(gap_index__next__gaps__skipped)
+{
+    gap_index index;
+    index.insert(10, 5);
+    index.insert(20, 1000);
+    BOOST_REQUIRE_EQUAL(index.next(0), 0u);
+    BOOST_REQUIRE_EQUAL(index.next(10), 15u);
+    BOOST_REQUIRE_EQUAL(index.next(14), 15u);
+    BOOST_REQUIRE_EQUAL(index.next(15), 15u);
+    BOOST_REQUIRE_EQUAL(index.next(500), 1020u);
+    BOOST_REQUIRE_EQUAL(index.next(1020), 1020u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <bitcoin/database.hpp>
+
+using namespace boost::system;
+using namespace boost::filesystem;
+using namespace bc;
+using namespace bc::database;
+
+#define DIRECTORY "hash_set"
+
+class hash_set_directory_setup_fixture
+{
+public:
+    hash_set_directory_setup_fixture()
+    {
+        error_code ec;
+        remove_all(DIRECTORY, ec);
+        BOOST_REQUIRE(create_directories(DIRECTORY, ec));
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(hash_set_tests, hash_set_directory_setup_fixture)
+
+static const hash_digest hash1 = hash_literal("0000000000000000000000000000000000000000000000000000000000000001");
+static const hash_digest hash2 = hash_literal("0000000000000000000000000000000000000000000000000000000000000002");
+static const hash_digest hash3 = hash_literal("0000000000000000000000000000000000000000000000000000000000000003");
+
+BOOST_AUTO_TEST_CASE(hash_set__insert_remove__contains_and_enumerates)
+{
+    store::create(DIRECTORY "/insert_remove");
+    memory_map file(DIRECTORY "/insert_remove");
+    BOOST_REQUIRE(file.open());
+    file.resize(minimum_records_size);
+
+    hash_set set(file);
+    BOOST_REQUIRE(set.create());
+    BOOST_REQUIRE(set.start());
+    BOOST_REQUIRE_EQUAL(set.size(), 0u);
+
+    BOOST_REQUIRE(set.insert(hash1));
+    BOOST_REQUIRE(set.insert(hash2));
+    BOOST_REQUIRE(set.insert(hash3));
+    BOOST_REQUIRE(!set.insert(hash2));
+    BOOST_REQUIRE_EQUAL(set.size(), 3u);
+    BOOST_REQUIRE(set.contains(hash2));
+
+    // Removal moves the last hash into the vacated record.
+    BOOST_REQUIRE(set.remove(hash1));
+    BOOST_REQUIRE(!set.remove(hash1));
+    BOOST_REQUIRE(!set.contains(hash1));
+    BOOST_REQUIRE_EQUAL(set.size(), 2u);
+
+    const auto hashes = set.hashes();
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE(hashes[0] == hash3);
+    BOOST_REQUIRE(hashes[1] == hash2);
+
+    // The moved hash remains removable at its new position.
+    BOOST_REQUIRE(set.remove(hash3));
+    BOOST_REQUIRE(set.remove(hash2));
+    BOOST_REQUIRE_EQUAL(set.size(), 0u);
+    BOOST_REQUIRE(set.hashes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(hash_set__start__reopen__positions_rebuilt)
+{
+    store::create(DIRECTORY "/reopen");
+
+    {
+        memory_map file(DIRECTORY "/reopen");
+        BOOST_REQUIRE(file.open());
+        file.resize(minimum_records_size);
+
+        hash_set set(file);
+        BOOST_REQUIRE(set.create());
+        BOOST_REQUIRE(set.start());
+        BOOST_REQUIRE(set.insert(hash1));
+        BOOST_REQUIRE(set.insert(hash2));
+        BOOST_REQUIRE(set.insert(hash3));
+        BOOST_REQUIRE(set.remove(hash1));
+        set.sync();
+        BOOST_REQUIRE(file.close());
+    }
+
+    memory_map file(DIRECTORY "/reopen");
+    BOOST_REQUIRE(file.open());
+
+    hash_set set(file);
+    BOOST_REQUIRE(set.start());
+    BOOST_REQUIRE_EQUAL(set.size(), 2u);
+    BOOST_REQUIRE(!set.contains(hash1));
+    BOOST_REQUIRE(set.contains(hash2));
+    BOOST_REQUIRE(set.contains(hash3));
+
+    // Removal after reopen relies on the rebuilt positions.
+    BOOST_REQUIRE(set.remove(hash3));
+    BOOST_REQUIRE(set.insert(hash1));
+
+    const auto hashes = set.hashes();
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE(hashes[0] == hash2);
+    BOOST_REQUIRE(hashes[1] == hash1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -430,5 +430,153 @@ BOOST_AUTO_TEST_CASE(record_hash_table__64bit__test)
     BOOST_REQUIRE(!ht.unlink(invalid));
 }
 
+BOOST_AUTO_TEST_CASE(record_hash_table__store_batch__test)
+{
+    BC_CONSTEXPR size_t record_buckets = 2;
+    BC_CONSTEXPR size_t header_size = record_hash_table_header_size(record_buckets);
+
+    store::create(DIRECTORY "/record_hash_table__store_batch");
+    memory_map file(DIRECTORY "/record_hash_table__store_batch");
+    BOOST_REQUIRE(file.open());
+    file.resize(header_size + minimum_records_size);
+
+    record_hash_table_header header(file, record_buckets);
+    BOOST_REQUIRE(header.create());
+    BOOST_REQUIRE(header.start());
+
+    typedef byte_array<4> tiny_hash;
+    BC_CONSTEXPR size_t record_size = hash_table_record_size<tiny_hash>(1);
+    const file_offset records_start = header_size;
+
+    record_manager alloc(file, records_start, record_size);
+    BOOST_REQUIRE(alloc.create());
+    BOOST_REQUIRE(alloc.start());
+
+    record_hash_table<tiny_hash> ht(header, alloc);
+    const record_hash_table<tiny_hash>::key_list none;
+    BOOST_REQUIRE_EQUAL(ht.store(none, nullptr), ht.not_found);
+
+    const record_hash_table<tiny_hash>::key_list keys
+    {
+        { { 0xde, 0xad, 0xbe, 0xef } },
+        { { 0xb0, 0x0b, 0xb0, 0x0b } },
+        { { 0xde, 0xad, 0xbe, 0xef } }
+    };
+
+    const auto write = [](byte_serializer& serial, size_t position)
+    {
+        serial.write_byte(static_cast<uint8_t>(position));
+    };
+
+    BOOST_REQUIRE_EQUAL(ht.store(keys, write), 0u);
+    alloc.sync();
+    BOOST_REQUIRE_EQUAL(alloc.count(), 3u);
+
+    // [2->0][1]
+    BOOST_REQUIRE_EQUAL(header.read(0), 2u);
+    BOOST_REQUIRE_EQUAL(header.read(1), 1u);
+    BOOST_REQUIRE_EQUAL(record_row<tiny_hash>(alloc, 2).next_index(), 0u);
+    BOOST_REQUIRE_EQUAL(record_row<tiny_hash>(alloc, 0).next_index(), header.empty);
+
+    // The last stored duplicate is found first.
+    const auto memory = ht.find(keys[1]);
+    BOOST_REQUIRE(memory);
+    BOOST_REQUIRE_EQUAL(*REMAP_ADDRESS(memory), 1u);
+    const auto memory2 = ht.find(keys[0]);
+    BOOST_REQUIRE(memory2);
+    BOOST_REQUIRE_EQUAL(*REMAP_ADDRESS(memory2), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(record_cluster_multimap__store_unlink__test)
+{
+    BC_CONSTEXPR size_t record_buckets = 2;
+    BC_CONSTEXPR size_t header_size = record_hash_table_header_size(record_buckets);
+
+    store::create(DIRECTORY "/record_cluster_multimap__lookup");
+    memory_map lookup_file(DIRECTORY "/record_cluster_multimap__lookup");
+    BOOST_REQUIRE(lookup_file.open());
+    lookup_file.resize(header_size + minimum_records_size);
+
+    record_hash_table_header header(lookup_file, record_buckets);
+    BOOST_REQUIRE(header.create());
+    BOOST_REQUIRE(header.start());
+
+    typedef byte_array<4> tiny_hash;
+    BC_CONSTEXPR size_t lookup_size = hash_table_cluster_multimap_record_size<tiny_hash>();
+    record_manager lookup_manager(lookup_file, header_size, lookup_size);
+    BOOST_REQUIRE(lookup_manager.create());
+    BOOST_REQUIRE(lookup_manager.start());
+    record_hash_table<tiny_hash> ht(header, lookup_manager);
+
+    store::create(DIRECTORY "/record_cluster_multimap__rows");
+    memory_map rows_file(DIRECTORY "/record_cluster_multimap__rows");
+    BOOST_REQUIRE(rows_file.open());
+    rows_file.resize(minimum_records_size);
+
+    const auto row_size = cluster_multimap_record_size(1);
+    record_manager rows_manager(rows_file, 0, row_size);
+    BOOST_REQUIRE(rows_manager.create());
+    BOOST_REQUIRE(rows_manager.start());
+
+    // Clusters of 2, 4, 4... rows.
+    record_cluster_multimap<tiny_hash> multimap(ht, rows_manager, 2, 4);
+
+    const tiny_hash key1{ { 0xde, 0xad, 0xbe, 0xef } };
+    const tiny_hash key2{ { 0xb0, 0x0b, 0xb0, 0x0b } };
+    const tiny_hash missing{ { 0x00, 0x00, 0x00, 0x00 } };
+    BOOST_REQUIRE(multimap.find(missing) == multimap.end());
+
+    // Interleave the keys, as blocks interleave addresses.
+    for (uint8_t value = 0; value < 7; ++value)
+    {
+        multimap.store(key1, [=](byte_serializer& serial) { serial.write_byte(value); });
+        multimap.store(key2, [=](byte_serializer& serial) { serial.write_byte(static_cast<uint8_t>(value + 100)); });
+    }
+
+    const auto read = [&](const tiny_hash& key)
+    {
+        std::vector<uint8_t> values;
+        for (auto it = multimap.find(key); it != multimap.end(); ++it)
+            values.push_back(*REMAP_ADDRESS(multimap.get(*it)));
+
+        return values;
+    };
+
+    const std::vector<uint8_t> expected1{ 6, 5, 4, 3, 2, 1, 0 };
+    const std::vector<uint8_t> expected2{ 106, 105, 104, 103, 102, 101, 100 };
+    BOOST_REQUIRE(read(key1) == expected1);
+    BOOST_REQUIRE(read(key2) == expected2);
+
+    // The rows of the second cluster of a key are contiguous.
+    auto it = multimap.find(key1);
+    ++it;
+    const auto cluster_last = *it;
+    ++it; ++it; ++it;
+    BOOST_REQUIRE_EQUAL(*it, cluster_last - 3);
+
+    // Three clusters of 2 + 4 + 4 rows plus headers for each of two keys.
+    rows_manager.sync();
+    BOOST_REQUIRE_EQUAL(rows_manager.count(), 2u * (3u + 10u));
+
+    // Unlink across the cluster boundary.
+    BOOST_REQUIRE(multimap.unlink(key1));
+    BOOST_REQUIRE(multimap.unlink(key1));
+    const std::vector<uint8_t> unlinked1{ 4, 3, 2, 1, 0 };
+    BOOST_REQUIRE(read(key1) == unlinked1);
+
+    // The unlinked row of the newest cluster is reused.
+    multimap.store(key1, [](byte_serializer& serial) { serial.write_byte(42); });
+    const std::vector<uint8_t> restored1{ 42, 4, 3, 2, 1, 0 };
+    BOOST_REQUIRE(read(key1) == restored1);
+    BOOST_REQUIRE(read(key2) == expected2);
+
+    for (size_t row = 0; row < restored1.size(); ++row)
+        BOOST_REQUIRE(multimap.unlink(key1));
+
+    BOOST_REQUIRE(!multimap.unlink(key1));
+    BOOST_REQUIRE(multimap.find(key1) == multimap.end());
+    BOOST_REQUIRE(read(key2) == expected2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
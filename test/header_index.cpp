@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/database.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::database;
+
+BOOST_AUTO_TEST_SUITE(header_index_tests)
+
+static header_index::entry make_entry(const header& header)
+{
+    header_index::entry value;
+    value.hash = header.hash();
+    const auto data = header.to_data(true);
+    std::copy(data.begin(), data.end(), value.header.begin());
+    return value;
+}
+
+BOOST_AUTO_TEST_CASE(header_index__construct__default__empty)
+{
+    const header_index index;
+    hash_digest hash;
+    BOOST_REQUIRE_EQUAL(index.size(), 0u);
+    BOOST_REQUIRE(!index.get(hash, 0));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__set__above_top__gaps)
+{
+    const auto header = block::genesis_mainnet().header();
+    header_index index;
+    index.set(2, make_entry(header));
+    BOOST_REQUIRE_EQUAL(index.size(), 3u);
+
+    hash_digest hash;
+    BOOST_REQUIRE(!index.get(hash, 0));
+    BOOST_REQUIRE(!index.get(hash, 1));
+    BOOST_REQUIRE(index.get(hash, 2));
+    BOOST_REQUIRE(hash == header.hash());
+
+    header_index::entry value;
+    BOOST_REQUIRE(index.get(value, 2));
+    BOOST_REQUIRE(header_index::to_header(value) == header);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__truncate__below_top__removed)
+{
+    const auto header = block::genesis_mainnet().header();
+    header_index index;
+    index.set(0, make_entry(header));
+    index.set(1, make_entry(header));
+    index.truncate(1);
+    BOOST_REQUIRE_EQUAL(index.size(), 1u);
+
+    hash_digest hash;
+    BOOST_REQUIRE(index.get(hash, 0));
+    BOOST_REQUIRE(!index.get(hash, 1));
+
+    index.truncate(42);
+    BOOST_REQUIRE_EQUAL(index.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__assign__entries__replaced)
+{
+    const auto header = block::genesis_mainnet().header();
+    header_index index;
+    index.set(5, make_entry(header));
+    index.assign({ make_entry(header), make_entry(header) });
+    BOOST_REQUIRE_EQUAL(index.size(), 2u);
+
+    hash_digest hash;
+    BOOST_REQUIRE(index.get(hash, 1));
+    BOOST_REQUIRE(hash == header.hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -193,8 +193,185 @@ BOOST_AUTO_TEST_CASE(history_database__test)
     auto res_1nr2 = db.get(key4, 0, 0);
     has_one_row(res_1nr2);
 
+    // Page through the rows of key1, two at a time.
+    payment_record::list paged;
+    const auto collect = [&](const payment_record& payment)
+    {
+        paged.push_back(payment);
+        return true;
+    };
+
+    auto cursor = db.get(key1, 2, 0, collect);
+    BOOST_REQUIRE_EQUAL(paged.size(), 2u);
+    BOOST_REQUIRE(cursor != history_database::end_of_history);
+    cursor = db.get(cursor, 2, 0, collect);
+    BOOST_REQUIRE_EQUAL(paged.size(), 4u);
+    BOOST_REQUIRE(cursor != history_database::end_of_history);
+    cursor = db.get(cursor, 2, 0, collect);
+    BOOST_REQUIRE(cursor == history_database::end_of_history);
+    fetch_s1(paged);
+
+    // A handler may stop the walk, returning the cursor of the next row.
+    const auto stop = [](const payment_record&)
+    {
+        return false;
+    };
+
+    cursor = db.get(key1, 0, 0, stop);
+    BOOST_REQUIRE(cursor != history_database::end_of_history);
+    paged.clear();
+    BOOST_REQUIRE(db.get(cursor, 0, 0, collect) == history_database::end_of_history);
+    BOOST_REQUIRE_EQUAL(paged.size(), 4u);
+
+    // A cursor beyond the rows is rejected without reading.
+    paged.clear();
+    BOOST_REQUIRE(db.get(static_cast<array_index>(db.statinfo().rows), 0, 0, collect) == history_database::end_of_history);
+    BOOST_REQUIRE(db.get(history_database::end_of_history - 1, 0, 0, collect) == history_database::end_of_history);
+    BOOST_REQUIRE(paged.empty());
+
     db.synchronize();
 }
 
+BOOST_AUTO_TEST_CASE(history_database__get__from_height__stops_below_height)
+{
+    const short_hash key = base16_literal("a006500b7ddfd568e2b036c7b2f0b3d96bd1e5d6");
+    const output_point out{ hash_literal("4129e76f363f9742bc98dd3d40c99c90eefa5d23968584be9d8d064bcf99c246"), 0 };
+
+    store::create(DIRECTORY "/history_table_from_height");
+    store::create(DIRECTORY "/history_rows_from_height");
+    history_database db(DIRECTORY "/history_table_from_height", DIRECTORY "/history_rows_from_height", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    // Rows are stored in height order, as blocks are pushed.
+    for (size_t height = 100; height < 110; ++height)
+        db.store(key, { height, out, height });
+
+    size_t visited = 0;
+    const auto count = [&](const payment_record& payment)
+    {
+        BOOST_REQUIRE_GE(payment.height(), 105u);
+        ++visited;
+        return true;
+    };
+
+    BOOST_REQUIRE(db.get(key, 0, 105, count) == history_database::end_of_history);
+    BOOST_REQUIRE_EQUAL(visited, 5u);
+
+    const auto history = db.get(key, 0, 108);
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_REQUIRE_EQUAL(history[0].height(), 109u);
+    BOOST_REQUIRE_EQUAL(history[1].height(), 108u);
+}
+
+BOOST_AUTO_TEST_CASE(history_database__get_summary__store_and_unlink__expected)
+{
+    const short_hash key = base16_literal("a006500b7ddfd568e2b036c7b2f0b3d96bd1e5d6");
+    const short_hash missing = base16_literal("9c6bd1e5d6a006500b7ddfd568e2b036c7b2f0b3");
+    const output_point out{ hash_literal("4129e76f363f9742bc98dd3d40c99c90eefa5d23968584be9d8d064bcf99c246"), 0 };
+    const input_point spend{ hash_literal("64a286efea9c6d3d7ac0c7ff2b3b3a3bcbbf94c2ab7e5c7a5fb0cb9c8b8b1a9c"), 0 };
+
+    store::create(DIRECTORY "/history_table_summary");
+    store::create(DIRECTORY "/history_rows_summary");
+    history_database db(DIRECTORY "/history_table_summary", DIRECTORY "/history_rows_summary", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    db.store(key, { 100, out, 5000 });
+    db.store(key, { 101, out, 3000 });
+    db.store(key, { 102, spend, out.checksum() }, 5000);
+
+    auto summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 3u);
+    BOOST_REQUIRE_EQUAL(summary.received, 8000u);
+    BOOST_REQUIRE_EQUAL(summary.spent, 5000u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 100u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 102u);
+    BOOST_REQUIRE(summary.ordered);
+
+    BOOST_REQUIRE(db.unlink_last_row(key, 5000));
+    summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 2u);
+    BOOST_REQUIRE_EQUAL(summary.received, 8000u);
+    BOOST_REQUIRE_EQUAL(summary.spent, 0u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 100u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 101u);
+
+    BOOST_REQUIRE(db.unlink_last_row(key));
+    summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 1u);
+    BOOST_REQUIRE_EQUAL(summary.received, 5000u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 100u);
+
+    BOOST_REQUIRE(db.unlink_last_row(key));
+    BOOST_REQUIRE(!db.unlink_last_row(key));
+    BOOST_REQUIRE_EQUAL(db.get_summary(key).rows, 0u);
+    BOOST_REQUIRE_EQUAL(db.get_summary(missing).rows, 0u);
+
+    // A recreated key starts from a zeroed summary.
+    db.store(key, { 110, out, 7000 });
+    summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 1u);
+    BOOST_REQUIRE_EQUAL(summary.received, 7000u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 110u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 110u);
+}
+
+BOOST_AUTO_TEST_CASE(history_database__get_summary__out_of_order__min_max_heights)
+{
+    const short_hash key = base16_literal("a006500b7ddfd568e2b036c7b2f0b3d96bd1e5d6");
+    const output_point out{ hash_literal("4129e76f363f9742bc98dd3d40c99c90eefa5d23968584be9d8d064bcf99c246"), 0 };
+
+    store::create(DIRECTORY "/history_table_summary_unordered");
+    store::create(DIRECTORY "/history_rows_summary_unordered");
+    history_database db(DIRECTORY "/history_table_summary_unordered", DIRECTORY "/history_rows_summary_unordered", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    // Parallel block insert may store rows out of height order.
+    db.store(key, { 105, out, 1 });
+    db.store(key, { 110, out, 2 });
+    db.store(key, { 100, out, 4 });
+
+    auto summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 3u);
+    BOOST_REQUIRE_EQUAL(summary.received, 7u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 100u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 110u);
+    BOOST_REQUIRE(!summary.ordered);
+
+    // Unlinking the lowest row rescans the remaining rows.
+    BOOST_REQUIRE(db.unlink_last_row(key));
+    summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 2u);
+    BOOST_REQUIRE_EQUAL(summary.received, 3u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 105u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 110u);
+
+    BOOST_REQUIRE(db.unlink_last_row(key));
+    summary = db.get_summary(key);
+    BOOST_REQUIRE_EQUAL(summary.rows, 1u);
+    BOOST_REQUIRE_EQUAL(summary.min_height, 105u);
+    BOOST_REQUIRE_EQUAL(summary.max_height, 105u);
+}
+
+BOOST_AUTO_TEST_CASE(history_database__get__from_height_out_of_order__skips_lower_rows)
+{
+    const short_hash key = base16_literal("a006500b7ddfd568e2b036c7b2f0b3d96bd1e5d6");
+    const output_point out{ hash_literal("4129e76f363f9742bc98dd3d40c99c90eefa5d23968584be9d8d064bcf99c246"), 0 };
+
+    store::create(DIRECTORY "/history_table_out_of_order");
+    store::create(DIRECTORY "/history_rows_out_of_order");
+    history_database db(DIRECTORY "/history_table_out_of_order", DIRECTORY "/history_rows_out_of_order", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    // Parallel block insert may store rows out of height order.
+    db.store(key, { 108, out, 1 });
+    db.store(key, { 102, out, 2 });
+    db.store(key, { 109, out, 3 });
+
+    const auto history = db.get(key, 0, 105);
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_REQUIRE_EQUAL(history[0].height(), 109u);
+    BOOST_REQUIRE_EQUAL(history[1].height(), 108u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -66,7 +66,9 @@ BOOST_AUTO_TEST_CASE(transaction_database__test)
     const auto h2 = tx2.hash();
 
     store::create(DIRECTORY "/tx_table");
-    transaction_database db(DIRECTORY "/tx_table", 1000, 50, 0);
+    store::create(DIRECTORY "/tx_pool_table");
+    store::create(DIRECTORY "/tx_pool_index");
+    transaction_database db(DIRECTORY "/tx_table", DIRECTORY "/tx_pool_table", DIRECTORY "/tx_pool_index", 1000, 100, 50, 0);
     BOOST_REQUIRE(db.create());
 
     db.store(tx1, 110, 0, 88);
@@ -78,7 +80,241 @@ BOOST_AUTO_TEST_CASE(transaction_database__test)
     const auto result2 = db.get(h2, max_size_t, false);
     BOOST_REQUIRE(result2.transaction().hash() == h2);
 
+    // Lazy accessors read directly from the slab.
+    BOOST_REQUIRE_EQUAL(result1.input_count(), tx1.inputs().size());
+    BOOST_REQUIRE_EQUAL(result1.output_count(), tx1.outputs().size());
+    BOOST_REQUIRE_EQUAL(result1.output_value(0), tx1.outputs()[0].value());
+    BOOST_REQUIRE_EQUAL(result1.output_value(1), chain::output::not_found);
+    BOOST_REQUIRE(to_chunk(result1.output_script(0)) == tx1.outputs()[0].script().to_data(false));
+    BOOST_REQUIRE(result1.output_script(1).empty());
+    BOOST_REQUIRE(result1.output_script_data(0) == tx1.outputs()[0].script().to_data(false));
+
+    // Raw wire serialization is streamed from the slab.
+    data_chunk raw;
+    BOOST_REQUIRE_EQUAL(result1.serialized_size(), wire_tx1.size());
+    BOOST_REQUIRE(db.get_data(raw, h1, max_size_t, false));
+    BOOST_REQUIRE(raw == wire_tx1);
+    BOOST_REQUIRE(db.get_data(raw, h2, max_size_t, false));
+    BOOST_REQUIRE(raw == wire_tx2);
+    BOOST_REQUIRE(!db.get_data(raw, null_hash, max_size_t, false));
+
+    db.synchronize();
+}
+
+BOOST_AUTO_TEST_CASE(transaction_database__get_outputs__test)
+{
+    data_chunk wire_tx1;
+    BOOST_REQUIRE(decode_base16(wire_tx1, "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"));
+
+    transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(wire_tx1, true));
+
+    data_chunk wire_tx2;
+    BOOST_REQUIRE(decode_base16(wire_tx2, "010000000147811c3fc0c0e750af5d0ea7343b16ea2d0c291c002e3db778669216eb689de80000000000ffffffff0118ddf505000000001976a914575c2f0ea88fcbad2389a372d942dea95addc25b88ac00000000"));
+
+    transaction tx2;
+    BOOST_REQUIRE(tx2.from_data(wire_tx2, true));
+
+    store::create(DIRECTORY "/tx_table_outputs");
+    store::create(DIRECTORY "/tx_pool_table_outputs");
+    store::create(DIRECTORY "/tx_pool_index_outputs");
+    transaction_database db(DIRECTORY "/tx_table_outputs", DIRECTORY "/tx_pool_table_outputs", DIRECTORY "/tx_pool_index_outputs", 1000, 100, 50, 0);
+    BOOST_REQUIRE(db.create());
+
+    // Stored in reverse order of reference, at distinct heights.
+    db.store(tx2, 4, 7, 0);
+    db.store(tx1, 110, 8, 88);
+
+    const input::list inputs
+    {
+        { { tx1.hash(), 0 }, {}, max_uint32 },
+        { { tx2.hash(), 0 }, {}, max_uint32 },
+        { { tx1.hash(), 1 }, {}, max_uint32 },
+        { { null_hash, 0 }, {}, max_uint32 }
+    };
+
+    const transaction spend{ 1, 0, inputs, {} };
+    const chain::block block1{ {}, { tx1, spend } };
+    const auto& points = block1.transactions()[1].inputs();
+
+    // The tx1 output is above the fork height.
+    BOOST_REQUIRE_EQUAL(db.get_outputs(block1, 100, true), 1u);
+    BOOST_REQUIRE(!points[0].previous_output().validation.cache.is_valid());
+    BOOST_REQUIRE(points[1].previous_output().validation.cache.is_valid());
+
+    BOOST_REQUIRE_EQUAL(db.get_outputs(block1, max_size_t, true), 2u);
+
+    const auto& prevout1 = points[0].previous_output().validation;
+    BOOST_REQUIRE(prevout1.cache == tx1.outputs()[0]);
+    BOOST_REQUIRE_EQUAL(prevout1.height, 110u);
+    BOOST_REQUIRE_EQUAL(prevout1.median_time_past, 8u);
+    BOOST_REQUIRE(!prevout1.coinbase);
+
+    const auto& prevout2 = points[1].previous_output().validation;
+    BOOST_REQUIRE(prevout2.cache == tx2.outputs()[0]);
+    BOOST_REQUIRE_EQUAL(prevout2.height, 4u);
+    BOOST_REQUIRE_EQUAL(prevout2.median_time_past, 7u);
+    BOOST_REQUIRE(prevout2.coinbase);
+
+    // Output index not in the tx and tx not in the store.
+    BOOST_REQUIRE(!points[2].previous_output().validation.cache.is_valid());
+    BOOST_REQUIRE(!points[3].previous_output().validation.cache.is_valid());
+    db.synchronize();
+}
+
+BOOST_AUTO_TEST_CASE(transaction_database__compressed__test)
+{
+    data_chunk wire_tx1;
+    BOOST_REQUIRE(decode_base16(wire_tx1, "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"));
+
+    transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(wire_tx1, true));
+
+    const auto h1 = tx1.hash();
+
+    store::create(DIRECTORY "/tx_table_compressed");
+    store::create(DIRECTORY "/tx_pool_table_compressed");
+    store::create(DIRECTORY "/tx_pool_index_compressed");
+    transaction_database db(DIRECTORY "/tx_table_compressed", DIRECTORY "/tx_pool_table_compressed", DIRECTORY "/tx_pool_index_compressed", 1000, 100, 50, 0, eviction_policy::fifo, true);
+    BOOST_REQUIRE(db.create());
+
+    db.store(tx1, 110, 0, 88);
+
+    const auto result1 = db.get(h1, max_size_t, false);
+    BOOST_REQUIRE(result1.transaction().hash() == h1);
+    BOOST_REQUIRE_EQUAL(result1.output_value(0), tx1.outputs()[0].value());
+    BOOST_REQUIRE(result1.compressed());
+    BOOST_REQUIRE(result1.output_script(0).empty());
+    BOOST_REQUIRE(result1.output_script_data(0) == tx1.outputs()[0].script().to_data(false));
+    BOOST_REQUIRE(result1.output(0).script() == tx1.outputs()[0].script());
+
+    data_chunk raw;
+    BOOST_REQUIRE(db.get_data(raw, h1, max_size_t, false));
+    BOOST_REQUIRE(raw == wire_tx1);
+
+    // Spender height is written to the first output word.
+    BOOST_REQUIRE(db.spend({ h1, 0 }, 111));
+    BOOST_REQUIRE_EQUAL(db.get(h1, max_size_t, false).output(0).validation.spender_height, 111u);
+    db.synchronize();
+}
+
+BOOST_AUTO_TEST_CASE(transaction_database__pool__test)
+{
+    data_chunk wire_tx1;
+    BOOST_REQUIRE(decode_base16(wire_tx1, "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"));
+
+    transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(wire_tx1, true));
+
+    const auto h1 = tx1.hash();
+
+    store::create(DIRECTORY "/tx_table_pool");
+    store::create(DIRECTORY "/tx_pool_table_pool");
+    store::create(DIRECTORY "/tx_pool_index_pool");
+    transaction_database db(DIRECTORY "/tx_table_pool", DIRECTORY "/tx_pool_table_pool", DIRECTORY "/tx_pool_index_pool", 1000, 100, 50, 0);
+    BOOST_REQUIRE(db.create());
+
+    // Unconfirmed txs are found by hash but not as confirmed.
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 0u);
+    db.store(tx1, 0, 0, transaction_database::unconfirmed);
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 1u);
+    BOOST_REQUIRE(db.unconfirmed_hashes().front() == h1);
+
+    // Compact block short ids resolve against unconfirmed txs.
+    const auto key = short_id_key(message::compact_block(
+        block::genesis_mainnet().header(), 42, {}, {}));
+    hash_list hashes;
+    BOOST_REQUIRE_EQUAL(db.resolve(hashes, { to_short_id(key, h1), 42 }, key), 1u);
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE(hashes[0] == h1);
+    BOOST_REQUIRE(hashes[1] == null_hash);
+    BOOST_REQUIRE(db.get(h1, max_size_t, false));
+    BOOST_REQUIRE(!db.get(h1, max_size_t, true));
+    BOOST_REQUIRE(!db.get(h1, max_size_t, false).confirmed());
+
+    // Confirmation migrates the tx to the confirmed table.
+    const auto offset = db.confirm(h1, 42, 7, 1);
+    BOOST_REQUIRE(offset != transaction_database::slab_map::not_found);
+
+    const auto result = db.get(offset);
+    BOOST_REQUIRE(result);
+    BOOST_REQUIRE(result.hash() == h1);
+    BOOST_REQUIRE(result.confirmed());
+    BOOST_REQUIRE_EQUAL(result.height(), 42u);
+    BOOST_REQUIRE_EQUAL(result.position(), 1u);
+    BOOST_REQUIRE(result.transaction().hash() == h1);
+    BOOST_REQUIRE(db.get(h1, max_size_t, true));
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 0u);
+
+    // Resolution under the same key follows changes to the pool.
+    BOOST_REQUIRE_EQUAL(db.resolve(hashes, { to_short_id(key, h1) }, key), 0u);
+    BOOST_REQUIRE(hashes[0] == null_hash);
+
+    // Demotion returns the tx to the unconfirmed index.
+    BOOST_REQUIRE(db.unconfirm(h1));
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 1u);
+    BOOST_REQUIRE_EQUAL(db.resolve(hashes, { to_short_id(key, h1) }, key), 1u);
+    BOOST_REQUIRE(hashes[0] == h1);
+
+    // Any confirmed store removes the tx from the unconfirmed index.
+    BOOST_REQUIRE(!tx1.validation.pooled);
+    db.store(tx1, 43, 7, 1);
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 0u);
+
+    // A demoted coinbase is never indexed.
+    const auto coinbase = block::genesis_mainnet().transactions().front();
+    db.store(coinbase, 0, 0, 0);
+    BOOST_REQUIRE(db.unconfirm(coinbase.hash()));
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 0u);
     db.synchronize();
 }
 
+BOOST_AUTO_TEST_CASE(transaction_database__compact_pool__migrated_pool_tx__compacted)
+{
+    data_chunk wire_tx1;
+    BOOST_REQUIRE(decode_base16(wire_tx1, "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"));
+
+    transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(wire_tx1, true));
+    auto tx2 = tx1;
+    tx2.set_locktime(1);
+
+    const auto h1 = tx1.hash();
+    const auto h2 = tx2.hash();
+
+    store::create(DIRECTORY "/tx_table_compact");
+    store::create(DIRECTORY "/tx_pool_table_compact");
+    store::create(DIRECTORY "/tx_pool_index_compact");
+
+    {
+        transaction_database db(DIRECTORY "/tx_table_compact", DIRECTORY "/tx_pool_table_compact", DIRECTORY "/tx_pool_index_compact", 1000, 100, 50, 0);
+        BOOST_REQUIRE(db.create());
+        db.store(tx1, 0, 0, transaction_database::unconfirmed);
+        db.store(tx2, 0, 0, transaction_database::unconfirmed);
+
+        // The pooled flag is not required to find the pooled tx.
+        BOOST_REQUIRE(!tx1.validation.pooled);
+        db.store(tx1, 42, 7, 1);
+        BOOST_REQUIRE(db.get(h1, max_size_t, true));
+        BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 1u);
+        db.synchronize();
+        BOOST_REQUIRE(db.close());
+    }
+
+    const auto uncompacted = file_size(DIRECTORY "/tx_pool_table_compact");
+
+    transaction_database db(DIRECTORY "/tx_table_compact", DIRECTORY "/tx_pool_table_compact", DIRECTORY "/tx_pool_index_compact", 1000, 100, 50, 0);
+    BOOST_REQUIRE(db.open());
+    BOOST_REQUIRE(db.compact_pool());
+    BOOST_REQUIRE(db.get(h1, max_size_t, true));
+    BOOST_REQUIRE(db.get(h2, max_size_t, false));
+    BOOST_REQUIRE(!db.get(h2, max_size_t, false).confirmed());
+    BOOST_REQUIRE(db.get(h2, max_size_t, false).transaction().hash() == h2);
+    BOOST_REQUIRE_EQUAL(db.unconfirmed_count(), 1u);
+    BOOST_REQUIRE(db.close());
+
+    // Only the remaining pooled tx is retained.
+    BOOST_REQUIRE_LT(file_size(DIRECTORY "/tx_pool_table_compact"), uncompacted);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
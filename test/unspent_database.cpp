@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <bitcoin/database.hpp>
+
+using namespace boost::system;
+using namespace boost::filesystem;
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::database;
+
+#define DIRECTORY "unspent_database"
+
+class unspent_database_directory_setup_fixture
+{
+public:
+    unspent_database_directory_setup_fixture()
+    {
+        error_code ec;
+        remove_all(DIRECTORY, ec);
+        BOOST_REQUIRE(create_directories(DIRECTORY, ec));
+    }
+
+    ////~unspent_database_directory_setup_fixture()
+    ////{
+    ////    error_code ec;
+    ////    remove_all(DIRECTORY, ec);
+    ////}
+};
+
+BOOST_FIXTURE_TEST_SUITE(database_tests, unspent_database_directory_setup_fixture)
+
+BOOST_AUTO_TEST_CASE(unspent_database__test)
+{
+    data_chunk wire_tx1;
+    BOOST_REQUIRE(decode_base16(wire_tx1, "0100000001537c9d05b5f7d67b09e5108e3bd5e466909cc9403ddd98bc42973f366fe729410600000000ffffffff0163000000000000001976a914fe06e7b4c88a719e92373de489c08244aee4520b88ac00000000"));
+
+    transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(wire_tx1, true));
+    const output_point key1{ tx1.hash(), 0 };
+    const output_point key2{ tx1.hash(), 1 };
+
+    store::create(DIRECTORY "/unspent_table");
+    unspent_database db(DIRECTORY "/unspent_table", 1000, 50);
+    BOOST_REQUIRE(db.create());
+
+    db.store(tx1, 42, 7);
+
+    bool coinbase;
+    size_t height;
+    uint32_t median_time_past;
+    chain::output output;
+
+    // Test fetch.
+    BOOST_REQUIRE(db.get(output, height, median_time_past, coinbase, key1));
+    BOOST_REQUIRE(output.is_valid());
+    BOOST_REQUIRE_EQUAL(output.value(), tx1.outputs()[0].value());
+    BOOST_REQUIRE(output.script() == tx1.outputs()[0].script());
+    BOOST_REQUIRE_EQUAL(height, 42u);
+    BOOST_REQUIRE_EQUAL(median_time_past, 7u);
+    BOOST_REQUIRE(!coinbase);
+
+    // Output above the fork point.
+    BOOST_REQUIRE(!db.get(output, height, median_time_past, coinbase, key1, 41));
+
+    // Output index not in the tx.
+    BOOST_REQUIRE(!db.get(output, height, median_time_past, coinbase, key2));
+
+    // Spend the output.
+    BOOST_REQUIRE(db.unlink(key1));
+    BOOST_REQUIRE(!db.unlink(key1));
+    BOOST_REQUIRE(!db.get(output, height, median_time_past, coinbase, key1));
+
+    // Restore the output.
+    db.store(key1, tx1.outputs()[0], 43, 8, true);
+    BOOST_REQUIRE(db.get(output, height, median_time_past, coinbase, key1));
+    BOOST_REQUIRE_EQUAL(output.value(), tx1.outputs()[0].value());
+    BOOST_REQUIRE_EQUAL(height, 43u);
+    BOOST_REQUIRE_EQUAL(median_time_past, 8u);
+    BOOST_REQUIRE(coinbase);
+    db.synchronize();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
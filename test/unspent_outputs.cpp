@@ -18,6 +18,7 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <boost/filesystem.hpp>
 #include <bitcoin/database.hpp>
 
 using namespace bc;
@@ -52,18 +53,90 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__construct__capacity_42__empty)
     BOOST_REQUIRE(cache.empty());
 }
 
+BOOST_AUTO_TEST_CASE(unspent_outputs__construct__capacity_42__one_shard)
+{
+    const unspent_outputs cache(42);
+    BOOST_REQUIRE_EQUAL(cache.shards(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__construct__large_capacity__maximum_shards)
+{
+    const unspent_outputs cache(unspent_outputs::maximum_shards * unspent_outputs::minimum_shard_capacity * 2);
+    BOOST_REQUIRE_EQUAL(cache.shards(), unspent_outputs::maximum_shards);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__many_sharded__expected_size)
+{
+    static const size_t count = 100;
+    unspent_outputs cache(unspent_outputs::maximum_shards * unspent_outputs::minimum_shard_capacity);
+    BOOST_REQUIRE_EQUAL(cache.shards(), unspent_outputs::maximum_shards);
+
+    for (uint32_t locktime = 0; locktime < count; ++locktime)
+        cache.add({ 0, locktime, {}, { { locktime, {} } } }, 0, 0, false);
+
+    BOOST_REQUIRE_EQUAL(cache.size(), count);
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+    const transaction tx{ 0, 42, {}, { { 42, {} } } };
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE_EQUAL(out_value.value(), 42u);
+    BOOST_REQUIRE(!cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx.hash(), 1 }, max_size_t, false));
+    BOOST_REQUIRE_EQUAL(cache.hit_rate(), 1.0f / 2.0f);
+}
+
 BOOST_AUTO_TEST_CASE(unspent_outputs__hit_rate__default__1)
 {
     const unspent_outputs cache(0);
     BOOST_REQUIRE_EQUAL(cache.hit_rate(), 1.0f);
 }
 
-BOOST_AUTO_TEST_CASE(unspent_outputs__add__one_capacity_42__size_1)
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__one_capacity_42__empty)
 {
     static const transaction tx{ 0, 0, input::list{}, output::list{ output{} } };
     unspent_outputs cache(42);
     cache.add(tx, 0, 0, false);
+    BOOST_REQUIRE(cache.empty());
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__one_capacity_one_output__size_1)
+{
+    static const transaction tx{ 0, 0, input::list{}, output::list{ output{} } };
+    unspent_outputs cache(unspent_outputs::output_overhead);
+    cache.add(tx, 0, 0, false);
     BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.usage(), unspent_outputs::output_overhead);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__oversized_script__charged)
+{
+    static const data_chunk data(unspent_outputs::inline_script_size + 1, 0x51);
+    static const transaction tx{ 0, 0, {}, { { 42, script{ data, false } } } };
+    unspent_outputs cache(42 * unspent_outputs::output_overhead);
+    cache.add(tx, 0, 0, false);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.usage(), unspent_outputs::output_overhead + data.size());
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE(out_value == tx.outputs()[0]);
+
+    cache.remove(tx);
+    BOOST_REQUIRE(cache.empty());
+    BOOST_REQUIRE_EQUAL(cache.usage(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__unspendable__empty)
+{
+    static const transaction tx{ 0, 0, {}, { { 0, script{ { machine::opcode::return_ } } } } };
+    unspent_outputs cache(42 * unspent_outputs::output_overhead);
+    cache.add(tx, 0, 0, false);
+    BOOST_REQUIRE(cache.empty());
 }
 
 BOOST_AUTO_TEST_CASE(unspent_outputs__add__no_outputs_capcity_42__empty)
@@ -85,11 +158,11 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__add__one_capcity_0__empty)
 BOOST_AUTO_TEST_CASE(unspent_outputs__remove1__remove_only__empty)
 {
     static const transaction tx{ 0, 0, {}, { {}, {} } };
-    unspent_outputs cache(1);
+    unspent_outputs cache(2 * unspent_outputs::output_overhead);
     cache.add(tx, 0, 0, false);
-    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
 
-    cache.remove(tx.hash());
+    cache.remove(tx);
     BOOST_REQUIRE(cache.empty());
 }
 
@@ -102,8 +175,9 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__remove1__capcity_0__empty)
 
 BOOST_AUTO_TEST_CASE(unspent_outputs__remove2__capcity_0__empty)
 {
+    static const transaction tx{ 0, 0, {}, { {}, {} } };
     unspent_outputs cache(0);
-    cache.remove(null_hash);
+    cache.remove(tx);
     BOOST_REQUIRE(cache.empty());
 }
 
@@ -113,10 +187,10 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__remove2__remove_one_output__expected_outpu
     static const uint64_t expected_value = 42;
     static const transaction tx1{ 0, 0, {}, { { 0, {} }, { 1, {} } } };
     static const transaction tx2{ 0, 0, {}, { { 0, {} }, { expected_value, {} } } };
-    unspent_outputs cache(42);
+    unspent_outputs cache(42 * unspent_outputs::output_overhead);
     cache.add(tx1, 0, 0, false);
     cache.add(tx2, expected_height, 0, false);
-    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 4u);
 
     bool out_coinbase;
     size_t out_height;
@@ -132,23 +206,47 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__remove2__remove_one_output__expected_outpu
     BOOST_REQUIRE_EQUAL(out_value.value(), expected_value);
 
     cache.remove({ tx1.hash(), 1 });
-    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 3u);
 
     cache.remove({ tx1.hash(), 0 });
-    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
     BOOST_REQUIRE(!cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 0 }, max_size_t, false));
     BOOST_REQUIRE(!cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 1 }, max_size_t, false));
     BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 0 }, max_size_t, false));
     BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 1 }, max_size_t, false));
 }
 
-BOOST_AUTO_TEST_CASE(unspent_outputs__get__two_capacity_1__size_1_expected)
+BOOST_AUTO_TEST_CASE(unspent_outputs__remove2__interleaved_outputs__remaining_found)
+{
+    static const uint32_t count = 64;
+    transaction tx;
+    tx.set_outputs(output::list(count, { 0, {} }));
+    unspent_outputs cache(count * unspent_outputs::output_overhead);
+    cache.add(tx, 0, 0, false);
+    BOOST_REQUIRE_EQUAL(cache.size(), count);
+
+    // Removal shifts colliding entries back within the probe run.
+    for (uint32_t index = 0; index < count; index += 2)
+        cache.remove({ tx.hash(), index });
+
+    BOOST_REQUIRE_EQUAL(cache.size(), count / 2);
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+
+    for (uint32_t index = 0; index < count; ++index)
+        BOOST_REQUIRE_EQUAL(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx.hash(), index }, max_size_t, false), index % 2 == 1);
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__get__two_capacity_2__size_2_expected)
 {
     static const size_t expected_height = 40;
     static const transaction tx1{ 0, 0, {}, { {}, {} } };
-    unspent_outputs cache(1);
+    unspent_outputs cache(2 * unspent_outputs::output_overhead);
     cache.add(tx1, expected_height, 0, false);
-    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
 
     bool out_coinbase;
     size_t out_height;
@@ -165,7 +263,8 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__get__two_capacity_1__size_1_expected)
     BOOST_REQUIRE(tx2.is_valid());
 
     cache.add(tx2, 0, 0, false);
-    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE(!cache.get(out_value1, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 1 }, max_size_t, false));
 
     chain::output out_value2a;
     BOOST_REQUIRE(cache.get(out_value2a, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 1 }, max_size_t, false));
@@ -178,4 +277,107 @@ BOOST_AUTO_TEST_CASE(unspent_outputs__get__two_capacity_1__size_1_expected)
     BOOST_REQUIRE_EQUAL(out_value2b.value(), expected2b);
 }
 
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__fifo_read_oldest__oldest_evicted)
+{
+    static const transaction tx1{ 0, 1, {}, { { 1, {} } } };
+    static const transaction tx2{ 0, 2, {}, { { 2, {} } } };
+    static const transaction tx3{ 0, 3, {}, { { 3, {} } } };
+    unspent_outputs cache(2 * unspent_outputs::output_overhead, eviction_policy::fifo);
+    cache.add(tx1, 0, 0, false);
+    cache.add(tx2, 0, 0, false);
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 0 }, max_size_t, false));
+
+    cache.add(tx3, 0, 0, false);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE(!cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 0 }, max_size_t, false));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__clock_read_oldest__oldest_spared)
+{
+    static const transaction tx1{ 0, 1, {}, { { 1, {} } } };
+    static const transaction tx2{ 0, 2, {}, { { 2, {} } } };
+    static const transaction tx3{ 0, 3, {}, { { 3, {} } } };
+    unspent_outputs cache(2 * unspent_outputs::output_overhead, eviction_policy::clock);
+    BOOST_REQUIRE(cache.policy() == eviction_policy::clock);
+    cache.add(tx1, 0, 0, false);
+    cache.add(tx2, 0, 0, false);
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 0 }, max_size_t, false));
+
+    cache.add(tx3, 0, 0, false);
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE(!cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE(cache.get(out_value, out_height, out_median_time_past, out_coinbase, { tx3.hash(), 0 }, max_size_t, false));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__add__selective_coinbase__empty)
+{
+    static const transaction tx{ 0, 0, { { { null_hash, point::null_index }, {}, 0 } }, { { 42, {} } } };
+    BOOST_REQUIRE(tx.is_coinbase());
+    unspent_outputs cache(42 * unspent_outputs::output_overhead, eviction_policy::selective);
+    cache.add(tx, 0, 0, false);
+    BOOST_REQUIRE(cache.empty());
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__to_string__policies__expected)
+{
+    BOOST_REQUIRE_EQUAL(to_string(eviction_policy::fifo), "fifo");
+    BOOST_REQUIRE_EQUAL(to_string(eviction_policy::clock), "clock");
+    BOOST_REQUIRE_EQUAL(to_string(eviction_policy::selective), "selective");
+}
+
+BOOST_AUTO_TEST_CASE(unspent_outputs__load__saved__expected_outputs)
+{
+    static const auto file = "unspent_outputs.snapshot";
+    static const hash_digest tag{ { 42 } };
+    static const data_chunk data(unspent_outputs::inline_script_size + 1, 0x51);
+    static const transaction tx1{ 0, 1, {}, { { 1, {} }, { 2, script{ data, false } } } };
+    static const transaction tx2{ 0, 2, { { { null_hash, point::null_index }, {}, 0 } }, { { 3, {} } } };
+    unspent_outputs cache(42 * unspent_outputs::output_overhead);
+    cache.add(tx1, 10, 11, true);
+    cache.add(tx2, 12, 13, false);
+    BOOST_REQUIRE(cache.save(file, tag));
+
+    unspent_outputs mismatched(42 * unspent_outputs::output_overhead);
+    BOOST_REQUIRE(!mismatched.load(file, null_hash));
+    BOOST_REQUIRE(mismatched.empty());
+
+    unspent_outputs loaded(42 * unspent_outputs::output_overhead);
+    BOOST_REQUIRE(loaded.load(file, tag));
+    BOOST_REQUIRE_EQUAL(loaded.size(), 3u);
+    BOOST_REQUIRE_EQUAL(loaded.usage(), cache.usage());
+
+    bool out_coinbase;
+    size_t out_height;
+    uint32_t out_median_time_past;
+    chain::output out_value;
+    BOOST_REQUIRE(loaded.get(out_value, out_height, out_median_time_past, out_coinbase, { tx1.hash(), 1 }, max_size_t, true));
+    BOOST_REQUIRE(out_value == tx1.outputs()[1]);
+    BOOST_REQUIRE_EQUAL(out_height, 10u);
+    BOOST_REQUIRE_EQUAL(out_median_time_past, 11u);
+    BOOST_REQUIRE(!out_coinbase);
+
+    BOOST_REQUIRE(!loaded.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 0 }, max_size_t, true));
+    BOOST_REQUIRE(loaded.get(out_value, out_height, out_median_time_past, out_coinbase, { tx2.hash(), 0 }, max_size_t, false));
+    BOOST_REQUIRE_EQUAL(out_value.value(), 3u);
+    BOOST_REQUIRE(out_coinbase);
+
+    // Selective does not admit the coinbase output.
+    unspent_outputs selective(42 * unspent_outputs::output_overhead, eviction_policy::selective);
+    BOOST_REQUIRE(selective.load(file, tag));
+    BOOST_REQUIRE_EQUAL(selective.size(), 2u);
+    boost::filesystem::remove(file);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
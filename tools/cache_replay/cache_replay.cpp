@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_CACHE_REPLAY_USAGE \
+    "Usage: cache_replay <directory> <first height> <count> <bytes>\n"
+#define BS_CACHE_REPLAY_OPEN_FAIL \
+    "Failed to open database files in %1%.\n"
+#define BS_CACHE_REPLAY_MISSING \
+    "Block %1% is not in the store, stopping.\n"
+#define BS_CACHE_REPLAY_RESULT \
+    "%1%: hit rate %2%, outputs %3%, bytes %4%\n"
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::database;
+using boost::format;
+
+// Replay confirmed blocks of a mainnet store through each cache policy.
+// Each prevout is read from (then removed from) each cache before the
+// outputs of its tx are added, as in block validation and commit.
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << BS_CACHE_REPLAY_USAGE;
+        return -1;
+    }
+
+    size_t first;
+    size_t count;
+    size_t capacity;
+    const std::string prefix(argv[1]);
+
+    try
+    {
+        first = boost::lexical_cast<size_t>(argv[2]);
+        count = boost::lexical_cast<size_t>(argv[3]);
+        capacity = boost::lexical_cast<size_t>(argv[4]);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+        std::cerr << BS_CACHE_REPLAY_USAGE;
+        return -1;
+    }
+
+    settings configuration(config::settings::mainnet);
+    configuration.directory = prefix;
+    data_base database(configuration);
+
+    if (!database.open())
+    {
+        std::cerr << format(BS_CACHE_REPLAY_OPEN_FAIL) % prefix;
+        return -1;
+    }
+
+    const std::vector<eviction_policy> policies
+    {
+        eviction_policy::fifo,
+        eviction_policy::clock,
+        eviction_policy::selective
+    };
+
+    std::vector<std::shared_ptr<unspent_outputs>> caches;
+
+    for (const auto policy: policies)
+        caches.push_back(std::make_shared<unspent_outputs>(capacity, policy));
+
+    bool coinbase;
+    size_t height;
+    uint32_t median_time_past;
+    output cached;
+
+    for (auto index = first; index < first + count; ++index)
+    {
+        const auto result = database.blocks().get(index);
+
+        // Compact blocks have no transaction offsets to replay.
+        if (!result || result.compact())
+        {
+            std::cerr << format(BS_CACHE_REPLAY_MISSING) % index;
+            break;
+        }
+
+        for (const auto offset: result.transaction_offsets())
+        {
+            const auto tx = database.transactions().get(offset).transaction();
+
+            for (const auto& cache: caches)
+            {
+                if (!tx.is_coinbase())
+                {
+                    for (const auto& input: tx.inputs())
+                    {
+                        const auto& prevout = input.previous_output();
+                        cache->get(cached, height, median_time_past, coinbase,
+                            prevout, max_size_t, true);
+                        cache->remove(prevout);
+                    }
+                }
+
+                cache->add(tx, index, 0, true);
+            }
+        }
+    }
+
+    for (const auto& cache: caches)
+        std::cout << format(BS_CACHE_REPLAY_RESULT) %
+            to_string(cache->policy()) % cache->hit_rate() % cache->size() %
+            cache->usage();
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_HISTORY_BENCH_USAGE \
+    "Usage: history_bench <directory> <addresses> <rows> [cluster rows]\n"
+#define BS_HISTORY_BENCH_CREATE_FAIL \
+    "Failed to create %1%.\n"
+#define BS_HISTORY_BENCH_RESULT \
+    "%1%: store %2%ms, walk %3%ms, pages/address %4%, rows file %5% bytes\n"
+
+using namespace bc;
+using namespace bc::database;
+using boost::format;
+using boost::filesystem::path;
+
+// The size of a history row value (see history_database).
+static constexpr size_t value_size = 47;
+static constexpr size_t page_size = 4096;
+static constexpr size_t buckets = 1000;
+
+typedef std::chrono::steady_clock clock_type;
+typedef std::function<void(size_t address, uint32_t height)> store_handler;
+typedef std::function<size_t(size_t address, std::set<size_t>& pages)>
+    walk_handler;
+
+static short_hash to_key(size_t address)
+{
+    short_hash key{};
+    auto serial = make_unsafe_serializer(key.data());
+    serial.write_8_bytes_little_endian(address);
+    return key;
+}
+
+static size_t elapsed(const clock_type::time_point& start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock_type::now() - start).count();
+}
+
+static void write_row(byte_serializer& serial, uint32_t height)
+{
+    static const data_chunk padding(value_size - sizeof(uint32_t), 0);
+    serial.write_4_bytes_little_endian(height);
+    serial.write_bytes(padding);
+}
+
+// Rows are stored round robin across addresses, as each block touches many
+// addresses, so that the rows of an address are interleaved with others.
+static void run(const std::string& name, const memory_map& rows_file,
+    size_t addresses, size_t rows, store_handler store, walk_handler walk)
+{
+    auto start = clock_type::now();
+
+    for (uint32_t height = 0; height < rows; ++height)
+        for (size_t address = 0; address < addresses; ++address)
+            store(address, height);
+
+    const auto store_time = elapsed(start);
+    size_t pages = 0;
+    size_t total = 0;
+    start = clock_type::now();
+
+    for (size_t address = 0; address < addresses; ++address)
+    {
+        std::set<size_t> touched;
+        total += walk(address, touched);
+        pages += touched.size();
+    }
+
+    const auto walk_time = elapsed(start);
+
+    if (total != addresses * rows * (rows - 1) / 2)
+        std::cerr << "Unexpected row heights.\n";
+
+    std::cout << format(BS_HISTORY_BENCH_RESULT) % name % store_time %
+        walk_time % (static_cast<double>(pages) / addresses) %
+        rows_file.size();
+}
+
+static bool create(memory_map& file, size_t size)
+{
+    if (!file.open())
+        return false;
+
+    // This will throw if insufficient disk space.
+    file.resize(size);
+    return true;
+}
+
+// Compare row walks of the linked row and clustered row multimaps.
+// Pages are the distinct file pages of the rows visited for an address,
+// which bounds the page faults of a cold walk.
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << BS_HISTORY_BENCH_USAGE;
+        return -1;
+    }
+
+    size_t addresses;
+    size_t rows;
+    size_t cluster_rows = 4;
+    const path directory(argv[1]);
+
+    try
+    {
+        addresses = boost::lexical_cast<size_t>(argv[2]);
+        rows = boost::lexical_cast<size_t>(argv[3]);
+
+        if (argc > 4)
+            cluster_rows = boost::lexical_cast<size_t>(argv[4]);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+        std::cerr << BS_HISTORY_BENCH_USAGE;
+        return -1;
+    }
+
+    const auto table_size = record_hash_table_header_size(buckets) +
+        minimum_records_size;
+
+    // Linked rows (record_multimap).
+    {
+        const auto lookup_path = directory / "linked_table";
+        const auto rows_path = directory / "linked_rows";
+
+        if (!store::create(lookup_path) || !store::create(rows_path))
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        memory_map lookup_file(lookup_path);
+        memory_map rows_file(rows_path);
+        const auto row_size = multimap_record_size(value_size);
+
+        if (!create(lookup_file, table_size) ||
+            !create(rows_file, minimum_records_size))
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        record_hash_table_header header(lookup_file, buckets);
+        record_manager lookup_manager(lookup_file,
+            record_hash_table_header_size(buckets),
+            hash_table_multimap_record_size<short_hash>());
+        record_hash_table<short_hash> table(header, lookup_manager);
+        record_manager rows_manager(rows_file, 0, row_size);
+        record_multimap<short_hash> multimap(table, rows_manager);
+
+        if (!header.create() || !header.start() ||
+            !lookup_manager.create() || !lookup_manager.start() ||
+            !rows_manager.create() || !rows_manager.start())
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        const auto store = [&](size_t address, uint32_t height)
+        {
+            multimap.store(to_key(address), [=](byte_serializer& serial)
+            {
+                write_row(serial, height);
+            });
+        };
+
+        const auto walk = [&](size_t address, std::set<size_t>& pages)
+        {
+            size_t total = 0;
+            const auto begin = multimap.find(to_key(address));
+
+            for (const auto index: record_multimap_iterable(rows_manager,
+                begin))
+            {
+                const auto memory = multimap.get(index);
+                total += from_little_endian_unsafe<uint32_t>(
+                    REMAP_ADDRESS(memory));
+                pages.insert(index * row_size / page_size);
+            }
+
+            return total;
+        };
+
+        run("linked", rows_file, addresses, rows, store, walk);
+    }
+
+    // Clustered rows (record_cluster_multimap).
+    {
+        const auto lookup_path = directory / "cluster_table";
+        const auto rows_path = directory / "cluster_rows";
+
+        if (!store::create(lookup_path) || !store::create(rows_path))
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        memory_map lookup_file(lookup_path);
+        memory_map rows_file(rows_path);
+        const auto row_size = cluster_multimap_record_size(value_size);
+
+        if (!create(lookup_file, table_size) ||
+            !create(rows_file, minimum_records_size))
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        record_hash_table_header header(lookup_file, buckets);
+        record_manager lookup_manager(lookup_file,
+            record_hash_table_header_size(buckets),
+            hash_table_cluster_multimap_record_size<short_hash>());
+        record_hash_table<short_hash> table(header, lookup_manager);
+        record_manager rows_manager(rows_file, 0, row_size);
+        record_cluster_multimap<short_hash> multimap(table, rows_manager,
+            cluster_rows);
+
+        if (!header.create() || !header.start() ||
+            !lookup_manager.create() || !lookup_manager.start() ||
+            !rows_manager.create() || !rows_manager.start())
+        {
+            std::cerr << format(BS_HISTORY_BENCH_CREATE_FAIL) % directory;
+            return -1;
+        }
+
+        const auto store = [&](size_t address, uint32_t height)
+        {
+            multimap.store(to_key(address), [=](byte_serializer& serial)
+            {
+                write_row(serial, height);
+            });
+        };
+
+        const auto walk = [&](size_t address, std::set<size_t>& pages)
+        {
+            size_t total = 0;
+
+            for (auto it = multimap.find(to_key(address));
+                it != multimap.end(); ++it)
+            {
+                const auto memory = multimap.get(*it);
+                total += from_little_endian_unsafe<uint32_t>(
+                    REMAP_ADDRESS(memory));
+                pages.insert(*it * row_size / page_size);
+            }
+
+            return total;
+        };
+
+        run("cluster", rows_file, addresses, rows, store, walk);
+    }
+
+    return 0;
+}